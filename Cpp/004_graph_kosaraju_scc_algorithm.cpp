@@ -9,8 +9,7 @@
 
 /*
 * Remark: works on Visual Studio 2015. May require work for use with other compilers.
-* Remark: for very big graphs, the stack size should be increased (>1MB). On Visual Studio 2015, change the "Stack Reserve Size"
-* parameter in Property Pages -> Configuration Properties -> Linker -> System.
+* Remark: the DFS loops use an explicit stack, hence big graphs do not need a bigger call stack.
 */
 
 // The input file "SCC.txt" is formatted as a set of lines 
@@ -18,142 +17,10 @@
 // For instance: "2 510" is an edge going from 2 to 510.
 // The total number of vertices in the graph has to be known!
 
-#include <iostream>
-#include <fstream>
-#include <sstream>
-#include <vector>
-#include <algorithm>
+#include "004_graph_kosaraju_scc_algorithm.hpp"
+#include "010_graph_vertex_reordering.hpp"
 
-/*
-* ------------------ *
-* CLASS DECLARATIONS *
-* ------------------ *
-*/
-
-class Edge;
-
-class Vertex {
-public:
-	int _index;
-	std::vector<Edge*> _in_edges;
-	std::vector<Edge*> _out_edges;
-	bool _explored;
-
-	inline Vertex(int _index) : _index(_index), _explored(false) {}
-	inline ~Vertex() {}
-};
-
-class Edge {
-public:
-	Vertex* _head;
-	Vertex* _tail;
-
-	inline Edge(Vertex* _h, Vertex* _t) : _head(_h), _tail(_t) {}
-	inline ~Edge() {}
-};
-
-class Graph {
-public:
-	std::vector<Vertex*> _vertexes;
-	std::vector<Edge*> _edges;
-
-	inline Graph() {}
-	~Graph();
-
-	void ResetVertexes();
-};
-
-struct Counter {
-public:
-	int value;
-	inline Counter() { value = 0; }
-};
-
-class DFS_handler {
-public:
-	inline DFS_handler(Graph* _g) : _graph(_g) {}
-
-	void DFS_Loop_Reversed();
-	void DFS_Loop_SCC();
-	inline std::vector<int>* getSCC() {
-		std::sort(_SCC_sizes.begin(), _SCC_sizes.end());
-		return &_SCC_sizes;
-	}
-
-private:
-	Graph* _graph;
-	std::vector<Vertex*> _stack_finish;
-	std::vector<int> _SCC_sizes;
-
-	void DFS_Reversed(Vertex*);
-	void DFS_SCC(Vertex*, Counter*);
-	
-};
-
-/*
-* ----------------------- *
-* METHODS IMPLEMENTATIONS *
-* ----------------------- *
-*/
-
-Graph::~Graph() {
-	for (std::vector<Vertex*>::iterator it = _vertexes.begin(); it < _vertexes.end(); it++) {
-		delete *it;
-	}
-	for (std::vector<Edge*>::iterator it = _edges.begin(); it < _edges.end(); it++) {
-		delete *it;
-	}
-}
-
-void Graph::ResetVertexes() {
-	for (std::vector<Vertex*>::iterator it = _vertexes.begin(); it < _vertexes.end(); it++) {
-		(*it)->_explored = false;
-	}
-}
-
-void DFS_handler::DFS_Loop_Reversed() {
-	_graph->ResetVertexes();
-	_stack_finish.clear();
-	for (Vertex* _vertex : _graph->_vertexes) {
-		if (!_vertex->_explored) {
-			DFS_Reversed(_vertex);
-		}
-	}
-}
-
-void DFS_handler::DFS_Reversed(Vertex* _vertex) {
-	if (!_vertex->_explored) {
-		_vertex->_explored = true;
-		for (Edge* _edge : _vertex->_in_edges) {
-			DFS_Reversed(_edge->_tail);
-		}
-		_stack_finish.push_back(_vertex);
-	}
-}
-
-void DFS_handler::DFS_Loop_SCC() {
-	_graph->ResetVertexes();
-	_SCC_sizes.clear();
-	Counter* _counter = new Counter();
-	for (std::vector<Vertex*>::reverse_iterator rit = _stack_finish.rbegin(); rit < _stack_finish.rend(); rit++) {
-		if (!(*rit)->_explored) {
-			_counter->value = 0;
-			DFS_SCC(*rit, _counter);
-			_SCC_sizes.push_back(_counter->value);
-		}
-	}
-	delete _counter;
-}
-
-void DFS_handler::DFS_SCC(Vertex* _vertex, Counter* _counter) {
-	if (!_vertex->_explored) {
-		_vertex->_explored = true;
-		_counter->value += 1;
-		for (Edge* _edge : _vertex->_out_edges) {
-			DFS_SCC(_edge->_head, _counter);
-		}
-	}
-}
+using namespace Kosaraju;
 
 /*
 * ---- *
@@ -168,42 +35,53 @@ int main() {
   // The total number of vertices in the graph has to be known!
 	std::ifstream myfile("SCC.txt");
   int vertexCount = 875714; // for instance
-	std::string* line = new std::string();
+	std::string reordering = "none"; // for instance "bfs", "rcm", "degree" or "gorder" (see 010_graph_vertex_reordering.hpp)
 
 	if (myfile.is_open()) {
 
-    // Creating the graph
-		Graph* g = new Graph();
-		for (int i = 0; i < vertexCount ; i++) {
-			g->_vertexes.push_back(new Vertex(i + 1));
+		Graph* g;
+		{
+			INSTRUMENT_SCOPED_TIMER("scc.load");
+			// Creating the graph
+			g = ReadGraph(myfile, vertexCount);
+			myfile.close();
 		}
 
 		std::cout << "Graph created. Size: " << g->_vertexes.size() << std::endl;
 
-		while (std::getline(myfile, *line)) {
-			//std::cout << line << std::endl;
-			std::istringstream iss(*line);
-			int tail;
-			int head;
-			iss >> tail;
-			iss >> head;
-			Edge* edge = new Edge(g->_vertexes.at(head - 1), g->_vertexes.at(tail - 1));
-			g->_vertexes.at(head - 1)->_in_edges.push_back(edge);
-			g->_vertexes.at(tail - 1)->_out_edges.push_back(edge);
+		// Relabel the vertexes so that the DFS visits neighbouring vertexes in memory (the SCC sizes do not depend on it)
+		if (reordering != "none") {
+			INSTRUMENT_SCOPED_TIMER("scc.reorder");
+			try {
+				g->Reorder(make_ordering(reordering, g->GetAdjacency()));
+			}
+			catch (const std::invalid_argument& e) {
+				std::cout << e.what() << std::endl;
+				return 1;
+			}
 		}
-		myfile.close();
-		delete line;
 
 		DFS_handler* dfsHandler = new DFS_handler(g);
-		dfsHandler->DFS_Loop_Reversed();
-		dfsHandler->DFS_Loop_SCC();
+		{
+			INSTRUMENT_SCOPED_TIMER("scc.pass1");
+			dfsHandler->DFS_Loop_Reversed();
+		}
+		{
+			INSTRUMENT_SCOPED_TIMER("scc.pass2");
+			dfsHandler->DFS_Loop_SCC();
+		}
 
-		std::vector<int>::reverse_iterator rit = dfsHandler->getSCC()->rbegin();
-		for (int i = 0; i < 10; i++) {
-			std::cout << *rit << std::endl;
-			rit++;
+		{
+			INSTRUMENT_SCOPED_TIMER("scc.query");
+			std::vector<int>::reverse_iterator rit = dfsHandler->getSCC()->rbegin();
+			for (int i = 0; i < 10; i++) {
+				std::cout << *rit << std::endl;
+				rit++;
+			}
 		}
 
+		INSTRUMENT_DUMP_JSON(std::cerr);
+
 	} else {
 		std::cout << "Unable to read file!" << std::endl;
 	}
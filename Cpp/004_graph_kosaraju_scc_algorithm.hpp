@@ -0,0 +1,351 @@
+/*
+* Created by 14chanwa on 2017.03.04
+*/
+
+/*
+* Strongly connected components in a directed graph
+* This file implements Kosaraju's Two-Pass Algorithm, that computes the SCCs of a directed graph using two Depth-First Search loops.
+*/
+
+/*
+* Remark: works on Visual Studio 2015. May require work for use with other compilers.
+* Remark: the DFS loops use an explicit stack, hence big graphs do not need a bigger call stack.
+*/
+
+// The input file "SCC.txt" is formatted as a set of lines 
+// Each line depicts an edge ; it is composed of 2 numbers, the tail index and the head index.
+// For instance: "2 510" is an edge going from 2 to 510.
+// The total number of vertices in the graph has to be known!
+
+#ifndef KOSARAJU_SCC_H
+#define KOSARAJU_SCC_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include "008_instrumentation.hpp"
+
+namespace Kosaraju {
+
+/*
+* ------------------ *
+* CLASS DECLARATIONS *
+* ------------------ *
+*/
+
+class Edge;
+
+class Vertex {
+public:
+	int _index;
+	std::vector<Edge*> _in_edges;
+	std::vector<Edge*> _out_edges;
+	int _component;						// the SCC of the vertex after DFS_Loop_SCC, by order of discovery
+
+	inline Vertex(int _index) : _index(_index), _component(-1) {}
+	inline ~Vertex() {}
+};
+
+class Edge {
+public:
+	Vertex* _head;
+	Vertex* _tail;
+
+	inline Edge(Vertex* _h, Vertex* _t) : _head(_h), _tail(_t) {}
+	inline ~Edge() {}
+};
+
+/*
+* Vertexes are looked up by _index, that must range from 1 to the number of vertexes.
+* The DFS runs on a compact copy of the edges (CSR): the tails of the in edges of the vertex at position i in _vertexes
+* are _in_tails[_in_offsets[i]] to _in_tails[_in_offsets[i + 1] - 1], and likewise for the heads of its out edges.
+* The compact copy stays with the graph, on top of the vertexes and the edges: 8 bytes per edge and 8 bytes per vertex.
+*/
+class Graph {
+public:
+	std::vector<Vertex*> _vertexes;
+	std::vector<Edge*> _edges;
+	std::vector<int> _in_offsets;
+	std::vector<int> _in_tails;
+	std::vector<int> _out_offsets;
+	std::vector<int> _out_heads;
+
+	inline Graph() {}
+	~Graph();
+
+	void Compact();						// builds the compact edges, unless they are up to date
+	std::vector<std::vector<int> > GetAdjacency();		// undirected adjacency lists, by position in _vertexes
+	void Reorder(const std::vector<int>&);			// given order[new position] = old position, stores the vertexes and edges contiguously in the new order
+
+private:
+	std::vector<Vertex> _vertex_pool;			// the vertexes and edges once reordered, _vertexes and _edges point into them
+	std::vector<Edge> _edge_pool;
+
+	std::vector<int> GetPositions();			// position in _vertexes of each index
+};
+
+Graph* ReadGraph(std::istream&, int _vertexCount = 0);	// reads the "tail head" lines of the input file, given the number of vertexes (more are created if an index is bigger)
+
+struct Counter {
+public:
+	int value;
+	inline Counter() { value = 0; }
+};
+
+class DFS_handler {
+public:
+	inline DFS_handler(Graph* _g) : _graph(_g) {}
+
+	void DFS_Loop_Reversed();				// first pass, on the reversed graph: orders the vertexes by finishing time
+	void DFS_Loop_SCC();					// second pass: computes the SCCs, sets the _component of the vertexes
+	inline std::vector<int>* getSCC() {
+		std::sort(_SCC_sizes.begin(), _SCC_sizes.end());
+		return &_SCC_sizes;
+	}
+	inline int getComponentSize(int _component) { return _component_sizes[_component]; }	// size of the SCC of the given id
+
+private:
+	Graph* _graph;
+	std::vector<bool> _explored;				// by position in _graph->_vertexes
+	std::vector<int> _stack_finish;				// positions of the vertexes by finishing time
+	std::vector<int> _components;				// SCC of each position
+	std::vector<std::pair<int, int> > _stack;		// DFS stack of (position, offset of the next edge to follow)
+	std::vector<int> _SCC_sizes;
+	std::vector<int> _component_sizes;			// sizes of the SCCs by id (_SCC_sizes gets sorted)
+
+	void DFS_Reversed(int);					// given an unexplored position
+	void DFS_SCC(int, Counter*);				// given an unexplored position
+	
+};
+
+/*
+* ----------------------- *
+* METHODS IMPLEMENTATIONS *
+* ----------------------- *
+*/
+
+inline Graph::~Graph() {
+	// The pooled vertexes and edges are freed with the pools
+	if (!_vertex_pool.empty()) {
+		return;
+	}
+	for (std::vector<Vertex*>::iterator it = _vertexes.begin(); it < _vertexes.end(); it++) {
+		delete *it;
+	}
+	for (std::vector<Edge*>::iterator it = _edges.begin(); it < _edges.end(); it++) {
+		delete *it;
+	}
+}
+
+inline std::vector<int> Graph::GetPositions() {
+	std::vector<int> _position(_vertexes.size() + 1, -1);
+	for (size_t i = 0; i < _vertexes.size(); i++) {
+		_position[_vertexes[i]->_index] = (int)i;
+	}
+	return _position;
+}
+
+inline void Graph::Compact() {
+	if (_in_offsets.size() == _vertexes.size() + 1 && _in_tails.size() == _edges.size()) {
+		return;
+	}
+	std::vector<int> _position = GetPositions();
+	_in_offsets.assign(1, 0);
+	_in_offsets.reserve(_vertexes.size() + 1);
+	_out_offsets.assign(1, 0);
+	_out_offsets.reserve(_vertexes.size() + 1);
+	_in_tails.clear();
+	_in_tails.reserve(_edges.size());
+	_out_heads.clear();
+	_out_heads.reserve(_edges.size());
+	for (Vertex* _vertex : _vertexes) {
+		for (Edge* _edge : _vertex->_in_edges) {
+			_in_tails.push_back(_position[_edge->_tail->_index]);
+		}
+		for (Edge* _edge : _vertex->_out_edges) {
+			_out_heads.push_back(_position[_edge->_head->_index]);
+		}
+		_in_offsets.push_back((int)_in_tails.size());
+		_out_offsets.push_back((int)_out_heads.size());
+	}
+}
+
+inline std::vector<std::vector<int> > Graph::GetAdjacency() {
+	std::vector<int> _position = GetPositions();
+	std::vector<std::vector<int> > _adjacency(_vertexes.size());
+	for (size_t i = 0; i < _vertexes.size(); i++) {
+		_adjacency[i].reserve(_vertexes[i]->_in_edges.size() + _vertexes[i]->_out_edges.size());
+	}
+	for (size_t i = 0; i < _vertexes.size(); i++) {
+		for (Edge* _edge : _vertexes[i]->_out_edges) {
+			int _head = _position[_edge->_head->_index];
+			_adjacency[i].push_back(_head);
+			_adjacency[_head].push_back((int)i);
+		}
+	}
+	return _adjacency;
+}
+
+inline void Graph::Reorder(const std::vector<int>& _order) {
+	// New position of each index
+	std::vector<int> _new_position(_vertexes.size() + 1, -1);
+	for (size_t i = 0; i < _order.size(); i++) {
+		_new_position[_vertexes[_order[i]]->_index] = (int)i;
+	}
+	// Vertexes in the new order. They keep the index of the input file.
+	std::vector<Vertex> _new_vertex_pool;
+	_new_vertex_pool.reserve(_order.size());
+	for (int _old_position : _order) {
+		Vertex* _old = _vertexes[_old_position];
+		_new_vertex_pool.push_back(Vertex(_old->_index));
+		_new_vertex_pool.back()._component = _old->_component;
+		_new_vertex_pool.back()._in_edges.reserve(_old->_in_edges.size());
+		_new_vertex_pool.back()._out_edges.reserve(_old->_out_edges.size());
+		std::vector<Edge*>().swap(_old->_in_edges);
+	}
+	// Edges in the order of their tail. Each old edge is in the out edges of exactly one vertex: it is freed once copied,
+	// so that the new vertexes reuse its memory.
+	std::vector<Edge> _new_edge_pool;
+	_new_edge_pool.reserve(_edges.size());
+	for (size_t i = 0; i < _order.size(); i++) {
+		Vertex* _old = _vertexes[_order[i]];
+		for (Edge* _edge : _old->_out_edges) {
+			Vertex* _head = &_new_vertex_pool[_new_position[_edge->_head->_index]];
+			_new_edge_pool.push_back(Edge(_head, &_new_vertex_pool[i]));
+			_new_vertex_pool[i]._out_edges.push_back(&_new_edge_pool.back());
+			_head->_in_edges.push_back(&_new_edge_pool.back());
+			if (_vertex_pool.empty()) {
+				delete _edge;
+			}
+		}
+		std::vector<Edge*>().swap(_old->_out_edges);
+	}
+
+	// Free the old vertexes, unless they are pooled
+	if (_vertex_pool.empty()) {
+		for (Vertex* _vertex : _vertexes) {
+			delete _vertex;
+		}
+	}
+	_vertex_pool.swap(_new_vertex_pool);
+	_edge_pool.swap(_new_edge_pool);
+	std::vector<Vertex>().swap(_new_vertex_pool);
+	std::vector<Edge>().swap(_new_edge_pool);
+	for (size_t i = 0; i < _vertex_pool.size(); i++) {
+		_vertexes[i] = &_vertex_pool[i];
+	}
+	for (size_t i = 0; i < _edge_pool.size(); i++) {
+		_edges[i] = &_edge_pool[i];
+	}
+	_in_offsets.clear();
+	Compact();
+}
+
+inline Graph* ReadGraph(std::istream& _file, int _vertexCount) {
+	Graph* g = new Graph();
+	for (int i = 0; i < _vertexCount; i++) {
+		g->_vertexes.push_back(new Vertex(i + 1));
+	}
+	std::string line;
+	while (std::getline(_file, line)) {
+		std::istringstream iss(line);
+		int tail;
+		int head;
+		if (!(iss >> tail >> head) || tail < 1 || head < 1) {
+			continue;
+		}
+		while ((int)g->_vertexes.size() < std::max(tail, head)) {
+			g->_vertexes.push_back(new Vertex((int)g->_vertexes.size() + 1));
+		}
+		Edge* edge = new Edge(g->_vertexes[head - 1], g->_vertexes[tail - 1]);
+		g->_vertexes[head - 1]->_in_edges.push_back(edge);
+		g->_vertexes[tail - 1]->_out_edges.push_back(edge);
+		g->_edges.push_back(edge);
+	}
+	return g;
+}
+
+inline void DFS_handler::DFS_Loop_Reversed() {
+	_graph->Compact();
+	_explored.assign(_graph->_vertexes.size(), false);
+	_stack_finish.clear();
+	_stack_finish.reserve(_graph->_vertexes.size());
+	for (int i = 0; i < (int)_graph->_vertexes.size(); i++) {
+		if (!_explored[i]) {
+			DFS_Reversed(i);
+		}
+	}
+}
+
+inline void DFS_handler::DFS_Reversed(int _start) {
+	// Iterative, so that long paths do not overflow the call stack
+	_explored[_start] = true;
+	_stack.push_back(std::make_pair(_start, _graph->_in_offsets[_start]));
+	while (!_stack.empty()) {
+		int _vertex = _stack.back().first;
+		int _next = _stack.back().second;
+		if (_next == _graph->_in_offsets[_vertex + 1]) {
+			INSTRUMENT_ADD("dfs.pass1.edges_scanned", _graph->_in_offsets[_vertex + 1] - _graph->_in_offsets[_vertex]);
+			_stack_finish.push_back(_vertex);
+			_stack.pop_back();
+			continue;
+		}
+		_stack.back().second++;
+		int _tail = _graph->_in_tails[_next];
+		if (!_explored[_tail]) {
+			_explored[_tail] = true;
+			_stack.push_back(std::make_pair(_tail, _graph->_in_offsets[_tail]));
+			INSTRUMENT_MAX("dfs.pass1.max_stack_depth", _stack.size());
+		}
+	}
+}
+
+inline void DFS_handler::DFS_Loop_SCC() {
+	_explored.assign(_graph->_vertexes.size(), false);
+	_components.assign(_graph->_vertexes.size(), -1);
+	_SCC_sizes.clear();
+	_component_sizes.clear();
+	Counter* _counter = new Counter();
+	for (std::vector<int>::reverse_iterator rit = _stack_finish.rbegin(); rit < _stack_finish.rend(); rit++) {
+		if (!_explored[*rit]) {
+			_counter->value = 0;
+			DFS_SCC(*rit, _counter);
+			_SCC_sizes.push_back(_counter->value);
+			_component_sizes.push_back(_counter->value);
+		}
+	}
+	delete _counter;
+	for (size_t i = 0; i < _components.size(); i++) {
+		_graph->_vertexes[i]->_component = _components[i];
+	}
+}
+
+inline void DFS_handler::DFS_SCC(int _start, Counter* _counter) {
+	_explored[_start] = true;
+	_stack.push_back(std::make_pair(_start, _graph->_out_offsets[_start]));
+	while (!_stack.empty()) {
+		int _vertex = _stack.back().first;
+		int _next = _stack.back().second;
+		if (_next == _graph->_out_offsets[_vertex + 1]) {
+			INSTRUMENT_ADD("dfs.pass2.edges_scanned", _graph->_out_offsets[_vertex + 1] - _graph->_out_offsets[_vertex]);
+			_components[_vertex] = (int)_component_sizes.size();
+			_counter->value += 1;
+			_stack.pop_back();
+			continue;
+		}
+		_stack.back().second++;
+		int _head = _graph->_out_heads[_next];
+		if (!_explored[_head]) {
+			_explored[_head] = true;
+			_stack.push_back(std::make_pair(_head, _graph->_out_offsets[_head]));
+			INSTRUMENT_MAX("dfs.pass2.max_stack_depth", _stack.size());
+		}
+	}
+}
+
+}
+
+#endif
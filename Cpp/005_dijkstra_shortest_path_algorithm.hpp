@@ -0,0 +1,473 @@
+/*
+* Created by 14chanwa on 2017.03.06
+*/
+
+/*
+* Dijkstra's Shortest Path Algorithm
+* This file implements the UNDIRECTED naive version of Dijkstra's Shortest Path Algorithm, that computes 
+* the shortest path between two vertexes in an UNDIRECTED graph with complexity O(n*m).
+*/
+
+/*
+* Remark: works on Visual Studio 2015. May require work for use with other compilers.
+*/
+
+// The input file "dijkstraData.txt" is formatted as a set of lines 
+// Each line begins with the current vertex id, followed by a series of tuples edge_target, weight
+// (current vertex is linked to edge_target with an edge of weight weight) 
+// The total number of vertices in the graph has to be known beforehand
+
+#ifndef DIJKSTRA_SHORTEST_PATH_H
+#define DIJKSTRA_SHORTEST_PATH_H
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <cstdlib>
+#include <vector>
+#include <map>
+#include <set>
+#include <limits>
+#include "006_heaps_template.hpp"
+#include "008_instrumentation.hpp"
+
+namespace Dijkstra {
+
+/*
+* ------------------ *
+* CLASS DECLARATIONS *
+* ------------------ *
+*/
+
+class Edge;
+
+class Vertex {
+public:
+	int m_index;
+	int m_Dijkstra_weight;
+	std::vector<Edge*> m_in_edges;
+
+	inline Vertex(int _index) : m_index(_index), m_Dijkstra_weight(std::numeric_limits<int>::max()) {}
+	inline ~Vertex() {}
+};
+
+class Edge {
+public:
+	Vertex* m_vertex1;
+	Vertex* m_vertex2;
+	int m_weight;
+
+	inline Edge(Vertex* _h, Vertex* _t, int _w) : m_vertex1(_h), m_vertex2(_t), m_weight(_w) {}
+	inline ~Edge() {}
+
+	inline Vertex* getOtherEnd(Vertex* end) {	// Given one end of the Edge, returns the other end. Does NOT check if the provided vertex is one end.
+		if (end == m_vertex1) {
+			return m_vertex2;
+		}
+		return m_vertex1;
+	}
+};
+
+/*
+* Vertexes are looked up by m_index, that must range from 1 to the number of vertexes.
+* DSP_handler_heap runs on a compact copy of the edges (CSR): the edges of the vertex at position i in m_vertexes are
+* m_adjacent_edges[m_offsets[i]] to m_adjacent_edges[m_offsets[i + 1] - 1], their other ends are at the positions
+* m_targets[...] and their weights are m_weights[...].
+* The compact copy stays with the graph, so that the handlers can answer many queries, on top of the vertexes and the
+* edges: 32 bytes per edge (it is stored at both ends) and 8 bytes per vertex. For instance, the peak RSS of the
+* Erdos-Renyi Dijkstra benchmark grows from 746MB to 976MB.
+*/
+class Graph {
+public:
+	std::vector<Vertex*> m_vertexes;
+	std::vector<Edge*> m_edges;
+	std::vector<int> m_positions;				// position in m_vertexes of the vertex of index i + 1
+	std::vector<int> m_offsets;
+	std::vector<int> m_targets;
+	std::vector<int> m_weights;
+	std::vector<Edge*> m_adjacent_edges;
+
+	inline Graph() {}
+	~Graph();
+
+	void Compact();						// builds the positions and the compact edges, unless they are up to date
+	std::vector<std::vector<int> > GetAdjacency();		// adjacency lists, by position in m_vertexes
+	void Reorder(const std::vector<int>&);			// given order[new position] = old position, stores the vertexes and edges contiguously in the new order
+
+private:
+	std::vector<Vertex> m_vertex_pool;			// the vertexes and edges once reordered, m_vertexes and m_edges point into them
+	std::vector<Edge> m_edge_pool;
+};
+
+void ReserveVertexes(Graph*, int);			// creates the vertexes up to the given index
+Graph* ReadGraph(std::istream&, int _vertexCount = 0);	// reads the "vertex<TAB>target,weight<TAB>..." lines of the input file, given the number of vertexes (more are created if an index is bigger)
+
+struct Counter {
+public:
+	int value;
+	inline Counter() { value = 0; }
+};
+
+class DSP_handler_naive {
+public:
+	Graph* m_graph;
+	Vertex* m_startVertex;
+	std::map<Vertex*, Edge*> m_vertex_route;
+	std::set<Vertex*> m_X;
+	
+	inline DSP_handler_naive(Graph* _g, Vertex* _s) : m_graph(_g), m_startVertex(_s) {}		// The naive implementation of Dijkstra's algorithm, complexity O(n*m).
+	void run();
+
+	std::vector<Edge*>* getReversedPath(Vertex* target);	// Gets the path from the end to the start point
+
+private:
+
+	
+	Edge* _getMinimumEdgeWeight();	// Gets the edge with one end in X and not the other, with the minimum Dijkstra weight, nullptr if none found.
+	Vertex* _getVertexInX(Edge*);	// Gets the first found end of the vertex which is in X, nullptr if none in X.
+
+};
+
+/*
+* Dijkstra's algorithm with the min heap of 006_heaps_template.hpp, complexity O(m*log(m)). A vertex may be pushed several
+* times in the heap: the outdated entries are skipped when popped. The buffers are kept from one run to the next, so that
+* one handler can answer many queries. It runs on the compact edges of the graph, by position in m_vertexes.
+*/
+class DSP_handler_heap {
+public:
+	Graph* m_graph;
+	Vertex* m_startVertex;
+
+	inline DSP_handler_heap(Graph* _g) : m_graph(_g), m_startVertex(nullptr) {}
+	void run(Vertex* _s);					// computes the shortest paths from the given start point
+
+	int getDistance(Vertex* target);			// Gets the length of the shortest path, max int if none
+	std::vector<Edge*>* getReversedPath(Vertex* target);	// Gets the path from the end to the start point
+
+private:
+	std::vector<int> m_distance;				// by position
+	std::vector<Edge*> m_route;				// the last edge of the shortest path to each vertex
+	std::vector<bool> m_settled;
+	std::vector<int> m_touched;				// the vertexes reached by the last run, reset by the next one
+	Heap_Min<std::pair<int, int> > m_queue;			// (distance, position)
+};
+
+/*
+* ----------------------- *
+* METHODS IMPLEMENTATIONS *
+* ----------------------- *
+*/
+
+inline Graph::~Graph() {
+	// The pooled vertexes and edges are freed with the pools
+	if (!m_vertex_pool.empty()) {
+		return;
+	}
+	for (std::vector<Vertex*>::iterator it = m_vertexes.begin(); it < m_vertexes.end(); it++) {
+		delete *it;
+	}
+	for (std::vector<Edge*>::iterator it = m_edges.begin(); it < m_edges.end(); it++) {
+		delete *it;
+	}
+}
+
+inline void Graph::Compact() {
+	// Each edge is in the in edges of both its ends
+	if (m_offsets.size() == m_vertexes.size() + 1 && m_targets.size() == 2 * m_edges.size()) {
+		return;
+	}
+	m_positions.assign(m_vertexes.size(), -1);
+	for (size_t i = 0; i < m_vertexes.size(); i++) {
+		m_positions[m_vertexes[i]->m_index - 1] = (int)i;
+	}
+	m_offsets.assign(1, 0);
+	m_offsets.reserve(m_vertexes.size() + 1);
+	m_targets.clear();
+	m_targets.reserve(2 * m_edges.size());
+	m_weights.clear();
+	m_weights.reserve(2 * m_edges.size());
+	m_adjacent_edges.clear();
+	m_adjacent_edges.reserve(2 * m_edges.size());
+	for (Vertex* _vertex : m_vertexes) {
+		for (Edge* _edge : _vertex->m_in_edges) {
+			m_targets.push_back(m_positions[_edge->getOtherEnd(_vertex)->m_index - 1]);
+			m_weights.push_back(_edge->m_weight);
+			m_adjacent_edges.push_back(_edge);
+		}
+		m_offsets.push_back((int)m_targets.size());
+	}
+}
+
+inline std::vector<std::vector<int> > Graph::GetAdjacency() {
+	Compact();
+	std::vector<std::vector<int> > _adjacency(m_vertexes.size());
+	for (size_t i = 0; i < m_vertexes.size(); i++) {
+		_adjacency[i].assign(m_targets.begin() + m_offsets[i], m_targets.begin() + m_offsets[i + 1]);
+	}
+	return _adjacency;
+}
+
+inline void Graph::Reorder(const std::vector<int>& _order) {
+	// New position of the vertex of index i + 1
+	std::vector<int> _new_position(m_vertexes.size());
+	for (size_t i = 0; i < _order.size(); i++) {
+		_new_position[m_vertexes[_order[i]]->m_index - 1] = (int)i;
+	}
+	// Vertexes in the new order. They keep the index of the input file.
+	std::vector<Vertex> _new_vertex_pool;
+	_new_vertex_pool.reserve(_order.size());
+	for (int _old_position : _order) {
+		Vertex* _old = m_vertexes[_old_position];
+		_new_vertex_pool.push_back(Vertex(_old->m_index));
+		_new_vertex_pool.back().m_Dijkstra_weight = _old->m_Dijkstra_weight;
+		_new_vertex_pool.back().m_in_edges.reserve(_old->m_in_edges.size());
+	}
+	// Edges in the order of their first end (counting sort)
+	std::vector<int> _first(_order.size() + 1, 0);
+	for (Edge* _edge : m_edges) {
+		_first[_new_position[_edge->m_vertex1->m_index - 1] + 1]++;
+	}
+	for (size_t i = 0; i < _order.size(); i++) {
+		_first[i + 1] += _first[i];
+	}
+	std::vector<Edge*> _sorted(m_edges.size());
+	for (Edge* _edge : m_edges) {
+		_sorted[_first[_new_position[_edge->m_vertex1->m_index - 1]]++] = _edge;
+	}
+	std::vector<Edge> _new_edge_pool;
+	_new_edge_pool.reserve(m_edges.size());
+	for (Edge* _edge : _sorted) {
+		Vertex* _vertex1 = &_new_vertex_pool[_new_position[_edge->m_vertex1->m_index - 1]];
+		Vertex* _vertex2 = &_new_vertex_pool[_new_position[_edge->m_vertex2->m_index - 1]];
+		_new_edge_pool.push_back(Edge(_vertex1, _vertex2, _edge->m_weight));
+		_vertex1->m_in_edges.push_back(&_new_edge_pool.back());
+		_vertex2->m_in_edges.push_back(&_new_edge_pool.back());
+	}
+
+	// Free the old vertexes and edges, unless they are pooled
+	if (m_vertex_pool.empty()) {
+		for (Vertex* _vertex : m_vertexes) {
+			delete _vertex;
+		}
+		for (Edge* _edge : m_edges) {
+			delete _edge;
+		}
+	}
+	m_vertex_pool.swap(_new_vertex_pool);
+	m_edge_pool.swap(_new_edge_pool);
+	std::vector<Vertex>().swap(_new_vertex_pool);
+	std::vector<Edge>().swap(_new_edge_pool);
+	for (size_t i = 0; i < m_vertex_pool.size(); i++) {
+		m_vertexes[i] = &m_vertex_pool[i];
+	}
+	for (size_t i = 0; i < m_edge_pool.size(); i++) {
+		m_edges[i] = &m_edge_pool[i];
+	}
+	m_offsets.clear();
+	Compact();
+}
+
+inline void ReserveVertexes(Graph* g, int _index) {
+	while ((int)g->m_vertexes.size() < _index) {
+		g->m_vertexes.push_back(new Vertex((int)g->m_vertexes.size() + 1));
+	}
+}
+
+inline Graph* ReadGraph(std::istream& _file, int _vertexCount) {
+	Graph* g = new Graph();
+	ReserveVertexes(g, _vertexCount);
+
+	std::string delimiter = "\t";
+	std::string line;
+
+	while (std::getline(_file, line)) {
+		if (line.empty()) {
+			continue;
+		}
+
+		size_t pos = 0;
+		std::string token;
+
+		// Read vertex id
+		pos = line.find(delimiter);
+		token = line.substr(0, pos);
+		line.erase(0, pos + delimiter.length());
+
+		// Malformed lines and tuples are skipped
+		int _current_vertex_id = std::atoi(token.c_str());
+		if (_current_vertex_id < 1) {
+			continue;
+		}
+		ReserveVertexes(g, _current_vertex_id);
+		Vertex* _current_vertex = g->m_vertexes[_current_vertex_id - 1];
+
+		// Read tuples (vertex, weight)
+		while ((pos = line.find(delimiter)) != std::string::npos) {
+			token = line.substr(0, pos);
+
+			// Append edge
+			size_t _comma = token.find_first_of(",");
+			int _target_vertice_id = std::atoi(token.substr(0, _comma).c_str());
+			std::string _weight_token = _comma == std::string::npos ? "" : token.substr(_comma + 1);
+			if (_target_vertice_id > _current_vertex_id && !_weight_token.empty() && _weight_token.find_first_not_of("0123456789") == std::string::npos) {
+				ReserveVertexes(g, _target_vertice_id);
+				Vertex* _target_vertex = g->m_vertexes[_target_vertice_id - 1];
+				int _weight = std::atoi(_weight_token.c_str());
+				Edge* _edge = new Edge(_current_vertex, _target_vertex, _weight);
+
+				_current_vertex->m_in_edges.push_back(_edge);
+				_target_vertex->m_in_edges.push_back(_edge);
+				g->m_edges.push_back(_edge);
+			}
+			line.erase(0, pos + delimiter.length());
+		}
+	}
+	return g;
+}
+
+inline void DSP_handler_naive::run() {
+	INSTRUMENT_ADD("dijkstra.queue_operations", 1);
+	m_X.insert(m_startVertex);
+	m_startVertex->m_Dijkstra_weight = 0;
+
+	while (m_X.size() < m_graph->m_vertexes.size()) {
+		Edge* _current_min = _getMinimumEdgeWeight();
+		
+		// If no edge found
+		if (_current_min == nullptr) {
+			break;
+		}
+
+		// Get target
+		Vertex* source = _getVertexInX(_current_min);
+		Vertex* target = _current_min->getOtherEnd(source);
+
+		// Update X and shortest path
+		INSTRUMENT_ADD("dijkstra.vertices_settled", 1);
+		INSTRUMENT_ADD("dijkstra.queue_operations", 1);
+		m_X.insert(target);
+		target->m_Dijkstra_weight = source->m_Dijkstra_weight + _current_min->m_weight;
+		m_vertex_route[target] = _current_min;
+	}
+}
+
+inline Edge* DSP_handler_naive::_getMinimumEdgeWeight() {
+	Edge* _current_min = nullptr;
+	int _current_min_weight = std::numeric_limits<int>::max();
+
+	for (Edge* e : m_graph->m_edges) {
+
+		Vertex* _extremityInX = _getVertexInX(e);
+
+		if (_extremityInX != nullptr && m_X.find(e->getOtherEnd(_extremityInX)) == m_X.end()) {
+			INSTRUMENT_ADD("dijkstra.edges_scanned", 1);
+			int _vertexWeight = _extremityInX->m_Dijkstra_weight;
+			if (e->m_weight + _vertexWeight < _current_min_weight) {
+				_current_min = e;
+				_current_min_weight = e->m_weight + _vertexWeight;
+			}
+		}
+	}
+	return _current_min;
+}
+
+inline Vertex* DSP_handler_naive::_getVertexInX(Edge* _e) {
+	if (m_X.find(_e->m_vertex1) != m_X.end()) {
+		return _e->m_vertex1;
+	}
+	else if (m_X.find(_e->m_vertex2) != m_X.end()) {
+		return _e->m_vertex2;
+	}
+	return nullptr;
+}
+
+inline std::vector<Edge*>* DSP_handler_naive::getReversedPath(Vertex* _t) {
+	std::vector<Edge*>* _path = new std::vector<Edge*>();
+	Vertex* _current_target = _t;
+	while (m_vertex_route.find(_current_target) != m_vertex_route.end()) {
+		Vertex* _current_source = m_vertex_route[_current_target]->getOtherEnd(_current_target);
+		_path->push_back(m_vertex_route[_current_target]);
+		_current_target = _current_source;
+	}
+	return _path;
+}
+
+inline void DSP_handler_heap::run(Vertex* _s) {
+	m_graph->Compact();
+	// Reset the buffers, only where the previous run wrote
+	size_t n = m_graph->m_vertexes.size();
+	if (m_distance.size() != n) {
+		m_distance.assign(n, std::numeric_limits<int>::max());
+		m_route.assign(n, nullptr);
+		m_settled.assign(n, false);
+	}
+	else {
+		for (int _slot : m_touched) {
+			m_distance[_slot] = std::numeric_limits<int>::max();
+			m_route[_slot] = nullptr;
+			m_settled[_slot] = false;
+		}
+	}
+	m_touched.clear();
+
+	m_startVertex = _s;
+	int _start = m_graph->m_positions[_s->m_index - 1];
+	m_distance[_start] = 0;
+	m_touched.push_back(_start);
+	m_queue.push(std::make_pair(0, _start));
+
+	while (!m_queue.empty()) {
+		INSTRUMENT_ADD("dijkstra.queue_operations", 1);
+		std::pair<int, int> _top = m_queue.pop();
+		int _source = _top.second;
+		if (m_settled[_source]) {
+			continue;
+		}
+		INSTRUMENT_ADD("dijkstra.vertices_settled", 1);
+		m_settled[_source] = true;
+
+		for (int i = m_graph->m_offsets[_source]; i < m_graph->m_offsets[_source + 1]; i++) {
+			int _slot = m_graph->m_targets[i];
+			if (m_settled[_slot]) {
+				continue;
+			}
+			INSTRUMENT_ADD("dijkstra.edges_relaxed", 1);
+			int _distance = _top.first + m_graph->m_weights[i];
+			if (_distance < m_distance[_slot]) {
+				if (m_distance[_slot] == std::numeric_limits<int>::max()) {
+					m_touched.push_back(_slot);
+				}
+				m_distance[_slot] = _distance;
+				m_route[_slot] = m_graph->m_adjacent_edges[i];
+				INSTRUMENT_ADD("dijkstra.queue_operations", 1);
+				m_queue.push(std::make_pair(_distance, _slot));
+			}
+		}
+	}
+}
+
+inline int DSP_handler_heap::getDistance(Vertex* _t) {
+	if (m_distance.empty()) {
+		return std::numeric_limits<int>::max();
+	}
+	return m_distance[m_graph->m_positions[_t->m_index - 1]];
+}
+
+inline std::vector<Edge*>* DSP_handler_heap::getReversedPath(Vertex* _t) {
+	std::vector<Edge*>* _path = new std::vector<Edge*>();
+	if (m_distance.empty()) {
+		return _path;
+	}
+	Vertex* _current_target = _t;
+	while (m_route[m_graph->m_positions[_current_target->m_index - 1]] != nullptr) {
+		Edge* _edge = m_route[m_graph->m_positions[_current_target->m_index - 1]];
+		_path->push_back(_edge);
+		_current_target = _edge->getOtherEnd(_current_target);
+	}
+	return _path;
+}
+
+}
+
+#endif
@@ -15,6 +15,7 @@
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include "008_instrumentation.hpp"
 
 /*
 * CLASS DECLARATION
@@ -27,6 +28,7 @@ template <typename T>
 class Heap {
 public:
 	inline Heap() {}
+	inline virtual ~Heap() {}
 
 	// Basic operations
 	T peek();						// returns the summit of the heap
@@ -36,6 +38,7 @@ public:
 
 	// Creation
 	virtual void heapify(std::vector<T>&) = 0;		// given a vector of elements, creates a valid heap
+	inline void reserve(int _n) { m_elements.reserve(_n); }	// allocates room for the given number of elements
 
 	// Inspection
 	inline int size() { return m_elements.size(); }		// returns the size of the heap
@@ -84,7 +87,7 @@ public:
 template<typename T>
 T Heap<T>::peek() {
 	if (m_elements.empty()) {
-		return 0;
+		return T();
 	}
 	else {
 		return m_elements[0];
@@ -93,6 +96,7 @@ T Heap<T>::peek() {
 
 template<typename T>
 void Heap<T>::switch_indexes(int i, int j) {
+	INSTRUMENT_ADD("heap.swaps", 1);
 	T _tmp = m_elements[i - 1];
 	m_elements[i - 1] = m_elements[j - 1];
 	m_elements[j - 1] = _tmp;
@@ -126,46 +130,56 @@ T Heap<T>::get_element(int _index) {
 
 template<typename T>
 void Heap_Min<T>::push(T _t) {
+	INSTRUMENT_ADD("heap.pushes", 1);
 	// Insert the element at the end of the vector
-	m_elements.push_back(_t);
+	this->m_elements.push_back(_t);
 	// Fix the heap
-	int current_index = m_elements.size(); // convention: array numbering starts with 1
+	int current_index = this->m_elements.size(); // convention: array numbering starts with 1
 	while (current_index > 1) {
 		int next_index = current_index / 2;
-		if (get_element(current_index) < get_element(next_index)) {
-			switch_indexes(current_index, next_index);
+		INSTRUMENT_ADD("heap.sift_up_steps", 1);
+		INSTRUMENT_ADD("heap.comparisons", 1);
+		// Once the parent is in order, so are all the ancestors
+		if (!(this->get_element(current_index) < this->get_element(next_index))) {
+			break;
 		}
+		this->switch_indexes(current_index, next_index);
 		current_index = next_index;
 	}
+	INSTRUMENT_MAX("heap.max_sift_up_depth", (unsigned long long)(std::floor(std::log2(this->m_elements.size())) - std::floor(std::log2(current_index))));
 }
 
 template<typename T>
 T Heap_Min<T>::pop() {
-	if (m_elements.empty()) {
-		return 0;
+	if (this->m_elements.empty()) {
+		return T();
 	}
+	INSTRUMENT_ADD("heap.pops", 1);
 	// Exchange first and last element of the array
 	// Delete the last element of the array
-	T _first_element = get_element(1);
-	switch_indexes(1, m_elements.size());
-	m_elements.pop_back();
+	T _first_element = this->get_element(1);
+	this->switch_indexes(1, this->m_elements.size());
+	this->m_elements.pop_back();
 	// Fix the heap
 	int current_index = 1; // convention: array numbering starts with 1
 
 	T _tmp;
-	while (current_index * 2 <= m_elements.size()) {
+	while (current_index * 2 <= this->m_elements.size()) {
+		INSTRUMENT_ADD("heap.sift_down_steps", 1);
 		// If 2 children
-		if (current_index * 2 + 1 <= m_elements.size()) {
-			_tmp = std::min(get_element(current_index * 2), get_element(current_index * 2 + 1));
+		if (current_index * 2 + 1 <= this->m_elements.size()) {
+			INSTRUMENT_ADD("heap.comparisons", 2);
+			_tmp = std::min(this->get_element(current_index * 2), this->get_element(current_index * 2 + 1));
 			// Check if need switch
-			if (get_element(current_index) > _tmp) {
+			if (this->get_element(current_index) > _tmp) {
 				// Switch the smallest element
-				if (get_element(current_index * 2) < get_element(current_index * 2 + 1)) {
-					switch_indexes(current_index, current_index * 2);
+				INSTRUMENT_ADD("heap.comparisons", 1);
+				if (this->get_element(current_index * 2) < this->get_element(current_index * 2 + 1)) {
+					this->switch_indexes(current_index, current_index * 2);
 					current_index = current_index * 2;
 				}
 				else {
-					switch_indexes(current_index, current_index * 2 + 1);
+					this->switch_indexes(current_index, current_index * 2 + 1);
 					current_index = current_index * 2 + 1;
 				}
 			}
@@ -175,37 +189,39 @@ T Heap_Min<T>::pop() {
 		}
 		// If one child
 		else {
-			if (get_element(current_index * 2) < get_element(current_index)) {
-				switch_indexes(current_index, current_index * 2);
+			INSTRUMENT_ADD("heap.comparisons", 1);
+			if (this->get_element(current_index * 2) < this->get_element(current_index)) {
+				this->switch_indexes(current_index, current_index * 2);
 				current_index = current_index * 2;
 			}
 			break;
 		}
 
 	}
+	INSTRUMENT_MAX("heap.max_sift_down_depth", (unsigned long long)std::floor(std::log2(current_index)));
 	return _first_element;
 }
 
 template<typename T>
 void Heap_Min<T>::heapify(std::vector<T>& _vec_t) {
 	std::sort(_vec_t.begin(), _vec_t.end());
-	for (std::vector<T>::iterator it = _vec_t.begin(); it < _vec_t.end(); it++) {
-		m_elements.push_back(*it);
+	for (typename std::vector<T>::iterator it = _vec_t.begin(); it < _vec_t.end(); it++) {
+		this->m_elements.push_back(*it);
 	}
 }
 
 template<typename T>
 bool Heap_Min<T>::check() {
-	for (int i = 1; i < m_elements.size() + 1; i++) {
-		if (2 * i <= m_elements.size()) {
-			if (get_element(i) > get_element(i * 2)) {
-				std::cout << i << ", " << 2 * i << ", size: " << m_elements.size() << std::endl;
+	for (int i = 1; i < this->m_elements.size() + 1; i++) {
+		if (2 * i <= this->m_elements.size()) {
+			if (this->get_element(i) > this->get_element(i * 2)) {
+				std::cout << i << ", " << 2 * i << ", size: " << this->m_elements.size() << std::endl;
 				return false;
 			}
 		}
-		if (2 * i + 1 <= m_elements.size()) {
-			if (get_element(i) > get_element(i * 2 + 1)) {
-				std::cout << i << ", " << 2 * i + 1 << ", size: " << m_elements.size() << std::endl;
+		if (2 * i + 1 <= this->m_elements.size()) {
+			if (this->get_element(i) > this->get_element(i * 2 + 1)) {
+				std::cout << i << ", " << 2 * i + 1 << ", size: " << this->m_elements.size() << std::endl;
 				return false;
 			}
 		}
@@ -215,46 +231,56 @@ bool Heap_Min<T>::check() {
 
 template<typename T>
 void Heap_Max<T>::push(T _t) {
+	INSTRUMENT_ADD("heap.pushes", 1);
 	// Insert the element at the end of the vector
-	m_elements.push_back(_t);
+	this->m_elements.push_back(_t);
 	// Fix the heap
-	int current_index = m_elements.size(); // convention: array numbering starts with 1
+	int current_index = this->m_elements.size(); // convention: array numbering starts with 1
 	while (current_index > 1) {
 		int next_index = current_index / 2;
-		if (get_element(current_index) > get_element(next_index)) {
-			switch_indexes(current_index, next_index);
+		INSTRUMENT_ADD("heap.sift_up_steps", 1);
+		INSTRUMENT_ADD("heap.comparisons", 1);
+		// Once the parent is in order, so are all the ancestors
+		if (!(this->get_element(current_index) > this->get_element(next_index))) {
+			break;
 		}
+		this->switch_indexes(current_index, next_index);
 		current_index = next_index;
 	}
+	INSTRUMENT_MAX("heap.max_sift_up_depth", (unsigned long long)(std::floor(std::log2(this->m_elements.size())) - std::floor(std::log2(current_index))));
 }
 
 template<typename T>
 T Heap_Max<T>::pop() {
-	if (m_elements.empty()) {
-		return 0;
+	if (this->m_elements.empty()) {
+		return T();
 	}
+	INSTRUMENT_ADD("heap.pops", 1);
 	// Exchange first and last element of the array
 	// Delete the last element of the array
-	T _first_element = get_element(1);
-	switch_indexes(1, m_elements.size());
-	m_elements.pop_back();
+	T _first_element = this->get_element(1);
+	this->switch_indexes(1, this->m_elements.size());
+	this->m_elements.pop_back();
 	// Fix the heap
 	int current_index = 1; // convention: array numbering starts with 1
 
 	T _tmp;
-	while (current_index * 2 <= m_elements.size()) {
+	while (current_index * 2 <= this->m_elements.size()) {
+		INSTRUMENT_ADD("heap.sift_down_steps", 1);
 		// If 2 children
-		if (current_index * 2 + 1 <= m_elements.size()) {
-			_tmp = std::max(get_element(current_index * 2), get_element(current_index * 2 + 1));
+		if (current_index * 2 + 1 <= this->m_elements.size()) {
+			INSTRUMENT_ADD("heap.comparisons", 2);
+			_tmp = std::max(this->get_element(current_index * 2), this->get_element(current_index * 2 + 1));
 			// Check if need switch
-			if (get_element(current_index) < _tmp) {
+			if (this->get_element(current_index) < _tmp) {
 				// Switch the biggest element
-				if (get_element(current_index * 2) > get_element(current_index * 2 + 1)) {
-					switch_indexes(current_index, current_index * 2);
+				INSTRUMENT_ADD("heap.comparisons", 1);
+				if (this->get_element(current_index * 2) > this->get_element(current_index * 2 + 1)) {
+					this->switch_indexes(current_index, current_index * 2);
 					current_index = current_index * 2;
 				}
 				else {
-					switch_indexes(current_index, current_index * 2 + 1);
+					this->switch_indexes(current_index, current_index * 2 + 1);
 					current_index = current_index * 2 + 1;
 				}
 			}
@@ -264,37 +290,39 @@ T Heap_Max<T>::pop() {
 		}
 		// If one child
 		else {
-			if (get_element(current_index * 2) > get_element(current_index)) {
-				switch_indexes(current_index, current_index * 2);
+			INSTRUMENT_ADD("heap.comparisons", 1);
+			if (this->get_element(current_index * 2) > this->get_element(current_index)) {
+				this->switch_indexes(current_index, current_index * 2);
 				current_index = current_index * 2;
 			}
 			break;
 		}
 
 	}
+	INSTRUMENT_MAX("heap.max_sift_down_depth", (unsigned long long)std::floor(std::log2(current_index)));
 	return _first_element;
 }
 
 template<typename T>
 void Heap_Max<T>::heapify(std::vector<T>& _vec_t) {
 	std::sort(_vec_t.begin(), _vec_t.end());
-	for (std::vector<T>::reverse_iterator rit = _vec_t.rbegin(); rit < _vec_t.rend(); rit++) {
-		m_elements.push_back(*rit);
+	for (typename std::vector<T>::reverse_iterator rit = _vec_t.rbegin(); rit < _vec_t.rend(); rit++) {
+		this->m_elements.push_back(*rit);
 	}
 }
 
 template<typename T>
 bool Heap_Max<T>::check() {
-	for (int i = 1; i < m_elements.size() + 1; i++) {
-		if (2 * i <= m_elements.size()) {
-			if (get_element(i) < get_element(i * 2)) {
-				std::cout << i << ", " << 2 * i << ", size: " << m_elements.size() << std::endl;
+	for (int i = 1; i < this->m_elements.size() + 1; i++) {
+		if (2 * i <= this->m_elements.size()) {
+			if (this->get_element(i) < this->get_element(i * 2)) {
+				std::cout << i << ", " << 2 * i << ", size: " << this->m_elements.size() << std::endl;
 				return false;
 			}
 		}
-		if (2 * i + 1 <= m_elements.size()) {
-			if (get_element(i) < get_element(i * 2 + 1)) {
-				std::cout << i << ", " << 2 * i + 1 << ", size: " << m_elements.size() << std::endl;
+		if (2 * i + 1 <= this->m_elements.size()) {
+			if (this->get_element(i) < this->get_element(i * 2 + 1)) {
+				std::cout << i << ", " << 2 * i + 1 << ", size: " << this->m_elements.size() << std::endl;
 				return false;
 			}
 		}
@@ -0,0 +1,504 @@
+/*
+* External-memory priority queue
+* Implements a min priority queue whose size is not bounded by the RAM. New elements are pushed in an in-memory
+* insertion buffer (a Heap_Min). When the buffer is full, it is emptied in order into a sorted run on disk.
+* The summit is the smallest element among the insertion buffer and the heads of the runs (k-way merge).
+* Runs are read by blocks, and the next block of each run is read in the background (read-ahead) by a reader thread,
+* one per queue, started at the first spill.
+* Runs are organized in levels, as in sequence heaps: a spill is a run of level 0. When the budget holds no more runs,
+* the runs of the lowest levels, at least "fan-in" of them, are merged into one run of the next level. Hence each element
+* is rewritten O(log_k(N/M)) times (k the fan-in, M the size of the insertion buffer, N the number of elements) instead of
+* at every merge.
+*/
+
+/*
+* Remark: T must be trivially copyable, since the elements are written as raw bytes in the run files.
+* The RAM used is bounded by the memory budget given to the constructor: a quarter of it for the insertion buffer
+* (allocated once), the rest for the run buffers (2 blocks per run) and the block being written by a spill or a merge.
+* The run buffers get the larger part since more runs mean fewer merges. The fan-in is the square root of the number
+* of runs the budget allows, so that several levels fit in the budget. The budget must allow at least 2 runs, i.e. be
+* at least 7 blocks, otherwise the constructor throws std::invalid_argument.
+* The run files are named after the process id and the queue address, so that several processes can share a directory.
+*/
+
+#ifndef EXTERNAL_PRIORITY_QUEUE_H
+#define EXTERNAL_PRIORITY_QUEUE_H
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <stdexcept>
+#include <type_traits>
+#include <cmath>
+#include <algorithm>
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+#include "006_heaps_template.hpp"
+#include "008_instrumentation.hpp"
+
+/*
+* CLASS DECLARATION
+*/
+
+template <typename T>
+class External_Run;
+
+/*
+* Reads the next blocks of the runs of a queue in the background, with a single thread.
+*/
+template <typename T>
+class External_Reader {
+public:
+	External_Reader() : m_waiting(nullptr), m_idle(false), m_stop(false) {}
+	~External_Reader();					// reads the requested blocks, then stops the thread
+
+	void request(External_Run<T>*);				// queues the read of the next block of the given run
+	void wait(External_Run<T>*);				// waits until the next block of the given run is read
+
+private:
+	std::thread m_thread;					// started at the first request
+	std::mutex m_mutex;
+	std::condition_variable m_requested;
+	std::condition_variable m_done;
+	std::deque<External_Run<T>*> m_requests;
+	External_Run<T>* m_waiting;				// the run whose block is waited for, if any
+	bool m_idle;						// whether the thread waits for requests
+	bool m_stop;
+
+	void loop();
+};
+
+/*
+* A sorted run stored in a file. Elements are read by blocks; the next block is read by the reader of the queue.
+*/
+template <typename T>
+class External_Run {
+	friend class External_Reader<T>;
+
+public:
+	External_Run(const std::string&, size_t, External_Reader<T>*);	// opens the given run file, with the given block size (in elements)
+	~External_Run();					// closes and deletes the run file
+
+	inline bool empty() { return m_position >= m_current_block.size(); }
+	inline T head() { return m_current_block[m_position]; }	// returns the current smallest element of the run
+	void next();						// moves to the next element of the run
+
+private:
+	std::string m_path;
+	std::ifstream m_file;
+	size_t m_block_size;
+	std::vector<T> m_current_block;				// the block being consumed
+	size_t m_position;					// position in the current block
+	std::vector<T> m_next_block;				// the block being read in the background
+	External_Reader<T>* m_reader;
+	bool m_read_ahead;					// whether the next block was requested
+	bool m_pending;						// whether the next block is not read yet (guarded by the reader)
+
+	void read_block(std::vector<T>*);			// reads the next block of the file in the given vector
+	void start_read_ahead();
+};
+
+/*
+* Head of a run in the k-way merge: an element and the index of the run it comes from.
+*/
+template <typename T>
+struct External_Run_Head {
+	T value;
+	size_t run;
+
+	inline External_Run_Head() : value(), run(0) {}
+	inline External_Run_Head(T _value, size_t _run) : value(_value), run(_run) {}
+	inline bool operator<(const External_Run_Head& _other) const { return value < _other.value; }
+	inline bool operator>(const External_Run_Head& _other) const { return _other.value < value; }
+};
+
+/*
+* Min priority queue spilling to disk (implements Extract-min)
+*/
+template <typename T>
+class External_Heap_Min {
+	static_assert(std::is_trivially_copyable<T>::value, "External_Heap_Min requires a trivially copyable type");
+
+public:
+	// Memory budget and block size in bytes, directory where the runs are written
+	External_Heap_Min(size_t _memory_budget = 64 << 20, size_t _block_size = 1 << 20, const std::string& _directory = ".");
+	~External_Heap_Min();
+
+	// Basic operations
+	T peek();						// returns the summit of the queue
+	void push(T);						// inserts a new element in the queue
+	T pop();						// returns and removes the summit of the queue
+
+	// Inspection
+	inline size_t size() { return m_size; }			// returns the size of the queue
+	inline bool empty() { return m_size == 0; }		// checks whether the queue is empty
+	inline size_t run_count() { return m_run_count; }	// returns the number of runs currently on disk
+
+private:
+	Heap_Min<T> m_insertion_heap;				// the insertion buffer
+	std::vector<External_Run<T>*> m_runs;			// the runs on disk, nullptr once exhausted
+	std::vector<size_t> m_run_levels;			// the level of each run
+	Heap_Min<External_Run_Head<T> > m_merge_heap;		// the heads of the non-empty runs
+	size_t m_size;
+	size_t m_run_count;					// number of non-exhausted runs
+	size_t m_insertion_capacity;				// max number of elements in the insertion buffer
+	size_t m_block_elements;				// number of elements per block
+	size_t m_max_runs;					// max number of runs given the memory budget
+	size_t m_fan_in;					// number of runs of a level merged into one run of the next level
+	std::string m_directory;
+	size_t m_file_counter;
+	External_Reader<T> m_reader;				// destroyed after the runs
+
+	std::string new_run_path();
+	void spill();						// empties the insertion buffer into a new run of level 0
+	void merge_runs(size_t);				// merges the runs up to the given level into a single run of the next level
+	size_t level_count(size_t);				// returns the number of runs of the given level
+	void rebuild();						// drops the exhausted runs and inserts the heads of the others in a new merge heap
+	void add_run(const std::string&, size_t);		// opens a run of the given level and inserts its head in the merge heap
+	void write_block(std::ofstream&, std::vector<T>&);
+	bool run_is_summit();					// checks whether the summit is the head of a run
+};
+
+
+
+
+/*
+* METHOD IMPLEMENTATION
+*/
+
+template<typename T>
+External_Reader<T>::~External_Reader() {
+	if (!m_thread.joinable()) {
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		m_stop = true;
+	}
+	m_requested.notify_one();
+	m_thread.join();
+}
+
+template<typename T>
+void External_Reader<T>::request(External_Run<T>* _run) {
+	bool _idle;
+	{
+		std::lock_guard<std::mutex> _lock(m_mutex);
+		_run->m_pending = true;
+		m_requests.push_back(_run);
+		_idle = m_idle;
+	}
+	if (!m_thread.joinable()) {
+		m_thread = std::thread(&External_Reader<T>::loop, this);
+	}
+	else if (_idle) {
+		m_requested.notify_one();
+	}
+}
+
+template<typename T>
+void External_Reader<T>::wait(External_Run<T>* _run) {
+	std::unique_lock<std::mutex> _lock(m_mutex);
+	m_waiting = _run;
+	m_done.wait(_lock, [_run] { return !_run->m_pending; });
+	m_waiting = nullptr;
+}
+
+template<typename T>
+void External_Reader<T>::loop() {
+	std::unique_lock<std::mutex> _lock(m_mutex);
+	while (true) {
+		m_idle = true;
+		m_requested.wait(_lock, [this] { return m_stop || !m_requests.empty(); });
+		m_idle = false;
+		if (m_requests.empty()) {
+			return;
+		}
+		External_Run<T>* _run = m_requests.front();
+		m_requests.pop_front();
+		// The run does not touch its next block until it is read
+		_lock.unlock();
+		_run->read_block(&_run->m_next_block);
+		_lock.lock();
+		_run->m_pending = false;
+		if (_run == m_waiting) {
+			_lock.unlock();
+			m_done.notify_one();
+			_lock.lock();
+		}
+	}
+}
+
+template<typename T>
+External_Run<T>::External_Run(const std::string& _path, size_t _block_size, External_Reader<T>* _reader) :
+	m_path(_path), m_file(_path, std::ios::binary), m_block_size(_block_size), m_position(0),
+	m_reader(_reader), m_read_ahead(false), m_pending(false) {
+	if (!m_file.is_open()) {
+		throw std::runtime_error("Unable to read run file " + _path);
+	}
+	read_block(&m_current_block);
+	start_read_ahead();
+}
+
+template<typename T>
+External_Run<T>::~External_Run() {
+	if (m_read_ahead) {
+		m_reader->wait(this);
+	}
+	m_file.close();
+	std::remove(m_path.c_str());
+}
+
+template<typename T>
+void External_Run<T>::read_block(std::vector<T>* _block) {
+	_block->resize(m_block_size);
+	m_file.read(reinterpret_cast<char*>(_block->data()), m_block_size * sizeof(T));
+	_block->resize(m_file.gcount() / sizeof(T));
+}
+
+template<typename T>
+void External_Run<T>::start_read_ahead() {
+	if (m_current_block.size() < m_block_size) {
+		// Last block already read
+		m_next_block.clear();
+		m_read_ahead = false;
+		return;
+	}
+	m_read_ahead = true;
+	m_reader->request(this);
+}
+
+template<typename T>
+void External_Run<T>::next() {
+	m_position++;
+	if (m_position < m_current_block.size() || !m_read_ahead) {
+		return;
+	}
+	// Current block consumed: switch to the block read in the background
+	m_reader->wait(this);
+	m_current_block.swap(m_next_block);
+	m_position = 0;
+	start_read_ahead();
+}
+
+template<typename T>
+External_Heap_Min<T>::External_Heap_Min(size_t _memory_budget, size_t _block_size, const std::string& _directory) :
+	m_size(0), m_run_count(0), m_directory(_directory), m_file_counter(0) {
+	m_block_elements = std::max<size_t>(1, _block_size / sizeof(T));
+	m_insertion_capacity = std::max<size_t>(1, _memory_budget / 4 / sizeof(T));
+	m_insertion_heap.reserve((int)m_insertion_capacity);
+	// 2 blocks per run, and 1 block to write a spill or a merge
+	size_t _blocks = (_memory_budget - _memory_budget / 4) / (m_block_elements * sizeof(T));
+	if (_blocks < 5) {
+		throw std::invalid_argument("External_Heap_Min: the memory budget must be at least 7 blocks");
+	}
+	m_max_runs = (_blocks - 1) / 2;
+	m_fan_in = std::max<size_t>(2, (size_t)std::sqrt((double)m_max_runs));
+}
+
+template<typename T>
+External_Heap_Min<T>::~External_Heap_Min() {
+	for (External_Run<T>* _run : m_runs) {
+		delete _run;
+	}
+}
+
+template<typename T>
+T External_Heap_Min<T>::peek() {
+	if (m_size == 0) {
+		return T();
+	}
+	if (run_is_summit()) {
+		return m_merge_heap.peek().value;
+	}
+	return m_insertion_heap.peek();
+}
+
+template<typename T>
+void External_Heap_Min<T>::push(T _t) {
+	if (m_insertion_heap.size() >= m_insertion_capacity) {
+		spill();
+	}
+	m_insertion_heap.push(_t);
+	m_size++;
+}
+
+template<typename T>
+T External_Heap_Min<T>::pop() {
+	if (m_size == 0) {
+		return T();
+	}
+	m_size--;
+	if (!run_is_summit()) {
+		return m_insertion_heap.pop();
+	}
+	// Take the head of the run and replace it by the next element of the same run
+	External_Run_Head<T> _head = m_merge_heap.pop();
+	External_Run<T>* _run = m_runs[_head.run];
+	_run->next();
+	if (_run->empty()) {
+		delete _run;
+		m_runs[_head.run] = nullptr;
+		m_run_count--;
+	}
+	else {
+		m_merge_heap.push(External_Run_Head<T>(_run->head(), _head.run));
+	}
+	return _head.value;
+}
+
+template<typename T>
+bool External_Heap_Min<T>::run_is_summit() {
+	if (m_merge_heap.empty()) {
+		return false;
+	}
+	if (m_insertion_heap.empty()) {
+		return true;
+	}
+	return m_merge_heap.peek().value < m_insertion_heap.peek();
+}
+
+template<typename T>
+std::string External_Heap_Min<T>::new_run_path() {
+	std::ostringstream _path;
+#ifdef _WIN32
+	_path << m_directory << "/external_heap_" << _getpid() << "_" << this << "_" << m_file_counter++ << ".run";
+#else
+	_path << m_directory << "/external_heap_" << getpid() << "_" << this << "_" << m_file_counter++ << ".run";
+#endif
+	return _path.str();
+}
+
+template<typename T>
+void External_Heap_Min<T>::write_block(std::ofstream& _file, std::vector<T>& _block) {
+	INSTRUMENT_ADD("external_heap.bytes_written", _block.size() * sizeof(T));
+	_file.write(reinterpret_cast<const char*>(_block.data()), _block.size() * sizeof(T));
+	if (!_file) {
+		throw std::runtime_error("Unable to write run file");
+	}
+	_block.clear();
+}
+
+template<typename T>
+void External_Heap_Min<T>::spill() {
+	if (m_run_count + 1 > m_max_runs) {
+		// No room for one more run: merge the lowest levels, at least m_fan_in runs, into the next level
+		size_t _level = 0;
+		size_t _count = level_count(0);
+		while (_count < m_fan_in) {
+			_count += level_count(++_level);
+		}
+		merge_runs(_level);
+	}
+	std::string _path = new_run_path();
+	std::ofstream _file(_path, std::ios::binary);
+	if (!_file.is_open()) {
+		throw std::runtime_error("Unable to create run file " + _path);
+	}
+	// Popping the insertion buffer gives its elements in order
+	std::vector<T> _block;
+	_block.reserve(m_block_elements);
+	while (!m_insertion_heap.empty()) {
+		_block.push_back(m_insertion_heap.pop());
+		if (_block.size() == m_block_elements) {
+			write_block(_file, _block);
+		}
+	}
+	write_block(_file, _block);
+	_file.close();
+	add_run(_path, 0);
+}
+
+template<typename T>
+size_t External_Heap_Min<T>::level_count(size_t _level) {
+	size_t _count = 0;
+	for (size_t i = 0; i < m_runs.size(); i++) {
+		if (m_runs[i] != nullptr && m_run_levels[i] == _level) {
+			_count++;
+		}
+	}
+	return _count;
+}
+
+template<typename T>
+void External_Heap_Min<T>::merge_runs(size_t _max_level) {
+	INSTRUMENT_ADD("external_heap.merges", 1);
+	std::string _path = new_run_path();
+	std::ofstream _file(_path, std::ios::binary);
+	if (!_file.is_open()) {
+		throw std::runtime_error("Unable to create run file " + _path);
+	}
+	// k-way merge of the remaining elements of the runs up to the given level. Their heads are also in m_merge_heap,
+	// which is rebuilt afterwards.
+	Heap_Min<External_Run_Head<T> > _heads;
+	for (size_t i = 0; i < m_runs.size(); i++) {
+		if (m_runs[i] != nullptr && m_run_levels[i] <= _max_level) {
+			_heads.push(External_Run_Head<T>(m_runs[i]->head(), i));
+		}
+	}
+	std::vector<T> _block;
+	_block.reserve(m_block_elements);
+	while (!_heads.empty()) {
+		External_Run_Head<T> _head = _heads.pop();
+		External_Run<T>* _run = m_runs[_head.run];
+		_block.push_back(_head.value);
+		if (_block.size() == m_block_elements) {
+			write_block(_file, _block);
+		}
+		_run->next();
+		if (!_run->empty()) {
+			_heads.push(External_Run_Head<T>(_run->head(), _head.run));
+		}
+	}
+	write_block(_file, _block);
+	_file.close();
+	for (size_t i = 0; i < m_runs.size(); i++) {
+		if (m_runs[i] != nullptr && m_run_levels[i] <= _max_level) {
+			delete m_runs[i];
+			m_runs[i] = nullptr;
+			m_run_count--;
+		}
+	}
+	rebuild();
+	add_run(_path, _max_level + 1);
+}
+
+template<typename T>
+void External_Heap_Min<T>::rebuild() {
+	std::vector<External_Run<T>*> _runs;
+	std::vector<size_t> _levels;
+	m_merge_heap = Heap_Min<External_Run_Head<T> >();
+	for (size_t i = 0; i < m_runs.size(); i++) {
+		if (m_runs[i] != nullptr) {
+			m_merge_heap.push(External_Run_Head<T>(m_runs[i]->head(), _runs.size()));
+			_runs.push_back(m_runs[i]);
+			_levels.push_back(m_run_levels[i]);
+		}
+	}
+	m_runs.swap(_runs);
+	m_run_levels.swap(_levels);
+}
+
+template<typename T>
+void External_Heap_Min<T>::add_run(const std::string& _path, size_t _level) {
+	External_Run<T>* _run = new External_Run<T>(_path, m_block_elements, &m_reader);
+	if (_run->empty()) {
+		delete _run;
+		return;
+	}
+	m_runs.push_back(_run);
+	m_run_levels.push_back(_level);
+	m_run_count++;
+	m_merge_heap.push(External_Run_Head<T>(_run->head(), m_runs.size() - 1));
+}
+
+#endif
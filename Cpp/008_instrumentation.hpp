@@ -0,0 +1,196 @@
+/*
+* Instrumentation
+* Implements counters, maxima and scoped timers that can be dumped as JSON or CSV.
+* The layer is compiled in only when BASICALGORITHMS_INSTRUMENTATION is defined (e.g. -DBASICALGORITHMS_INSTRUMENTATION).
+* Otherwise every INSTRUMENT_* macro expands to nothing, and the instrumented code is exactly the original one.
+*/
+
+/*
+* Usage:
+*	INSTRUMENT_ADD("heap.swaps", 1);			// adds a value to a counter
+*	INSTRUMENT_MAX("heap.max_sift_down_depth", depth);	// keeps the maximum of the given values
+*	INSTRUMENT_SCOPED_DEPTH("dfs.max_stack_depth");		// keeps the maximum nesting of the current scope (e.g. recursion depth)
+*	INSTRUMENT_SCOPED_TIMER("scc.load");			// times the current scope
+*	INSTRUMENT_DUMP_JSON(std::cerr);			// prints everything (resp. INSTRUMENT_DUMP_CSV)
+* Remark: the counters are not thread-safe.
+*/
+
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#ifdef BASICALGORITHMS_INSTRUMENTATION
+
+#include <map>
+#include <string>
+#include <chrono>
+#include <ostream>
+
+/*
+* CLASS DECLARATION
+*/
+
+struct Instrumentation_Timer {
+	unsigned long long calls;
+	double total_seconds;
+
+	inline Instrumentation_Timer() : calls(0), total_seconds(0) {}
+};
+
+/*
+* Registry of all the counters, maxima and timers of the program
+*/
+class Instrumentation {
+public:
+	static inline std::map<std::string, unsigned long long>& counters() {
+		static std::map<std::string, unsigned long long> _counters;
+		return _counters;
+	}
+	static inline std::map<std::string, unsigned long long>& maxima() {
+		static std::map<std::string, unsigned long long> _maxima;
+		return _maxima;
+	}
+	static inline std::map<std::string, Instrumentation_Timer>& timers() {
+		static std::map<std::string, Instrumentation_Timer> _timers;
+		return _timers;
+	}
+
+	static inline void update_max(unsigned long long& _max, unsigned long long _value) {
+		if (_value > _max) {
+			_max = _value;
+		}
+	}
+
+	static void dump_json(std::ostream&);
+	static void dump_csv(std::ostream&);
+	static void reset();
+};
+
+/*
+* Adds the time spent in its scope to the given timer
+*/
+class Scoped_Timer {
+public:
+	inline Scoped_Timer(Instrumentation_Timer& _timer) : m_timer(_timer), m_start(std::chrono::steady_clock::now()) {}
+	inline ~Scoped_Timer() {
+		m_timer.calls++;
+		m_timer.total_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	}
+
+private:
+	Instrumentation_Timer& m_timer;
+	std::chrono::steady_clock::time_point m_start;
+};
+
+/*
+* Increments a depth on construction, decrements it on destruction, and keeps track of the maximum depth
+*/
+class Scoped_Depth {
+public:
+	inline Scoped_Depth(unsigned long long& _depth, unsigned long long& _max) : m_depth(_depth) {
+		Instrumentation::update_max(_max, ++m_depth);
+	}
+	inline ~Scoped_Depth() { m_depth--; }
+
+private:
+	unsigned long long& m_depth;
+};
+
+
+
+
+/*
+* METHOD IMPLEMENTATION
+*/
+
+inline void Instrumentation::dump_json(std::ostream& _out) {
+	_out << "{\n\t\"counters\": {";
+	const char* _separator = "\n";
+	for (auto& _counter : counters()) {
+		_out << _separator << "\t\t\"" << _counter.first << "\": " << _counter.second;
+		_separator = ",\n";
+	}
+	_out << "\n\t},\n\t\"maxima\": {";
+	_separator = "\n";
+	for (auto& _max : maxima()) {
+		_out << _separator << "\t\t\"" << _max.first << "\": " << _max.second;
+		_separator = ",\n";
+	}
+	_out << "\n\t},\n\t\"timers\": {";
+	_separator = "\n";
+	for (auto& _timer : timers()) {
+		_out << _separator << "\t\t\"" << _timer.first << "\": { \"calls\": " << _timer.second.calls
+			<< ", \"total_seconds\": " << _timer.second.total_seconds << " }";
+		_separator = ",\n";
+	}
+	_out << "\n\t}\n}" << std::endl;
+}
+
+inline void Instrumentation::dump_csv(std::ostream& _out) {
+	_out << "kind,name,calls,value" << std::endl;
+	for (auto& _counter : counters()) {
+		_out << "counter," << _counter.first << ",," << _counter.second << std::endl;
+	}
+	for (auto& _max : maxima()) {
+		_out << "max," << _max.first << ",," << _max.second << std::endl;
+	}
+	for (auto& _timer : timers()) {
+		_out << "timer," << _timer.first << "," << _timer.second.calls << "," << _timer.second.total_seconds << std::endl;
+	}
+}
+
+inline void Instrumentation::reset() {
+	for (auto& _counter : counters()) {
+		_counter.second = 0;
+	}
+	for (auto& _max : maxima()) {
+		_max.second = 0;
+	}
+	for (auto& _timer : timers()) {
+		_timer.second = Instrumentation_Timer();
+	}
+}
+
+/*
+* MACROS
+* Each call site looks up its entry in the registry once (function-local static), then only does an addition.
+*/
+
+#define INSTRUMENT_CONCAT_(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_(a, b)
+
+#define INSTRUMENT_ADD(_name, _value) do { \
+		static unsigned long long& _instrument_counter = Instrumentation::counters()[_name]; \
+		_instrument_counter += (_value); \
+	} while (0)
+
+#define INSTRUMENT_MAX(_name, _value) do { \
+		static unsigned long long& _instrument_max = Instrumentation::maxima()[_name]; \
+		Instrumentation::update_max(_instrument_max, (_value)); \
+	} while (0)
+
+#define INSTRUMENT_SCOPED_TIMER(_name) \
+	static Instrumentation_Timer& INSTRUMENT_CONCAT(_instrument_timer_, __LINE__) = Instrumentation::timers()[_name]; \
+	Scoped_Timer INSTRUMENT_CONCAT(_instrument_scoped_timer_, __LINE__)(INSTRUMENT_CONCAT(_instrument_timer_, __LINE__))
+
+#define INSTRUMENT_SCOPED_DEPTH(_name) \
+	static unsigned long long INSTRUMENT_CONCAT(_instrument_depth_, __LINE__) = 0; \
+	static unsigned long long& INSTRUMENT_CONCAT(_instrument_max_depth_, __LINE__) = Instrumentation::maxima()[_name]; \
+	Scoped_Depth INSTRUMENT_CONCAT(_instrument_scoped_depth_, __LINE__)(INSTRUMENT_CONCAT(_instrument_depth_, __LINE__), INSTRUMENT_CONCAT(_instrument_max_depth_, __LINE__))
+
+#define INSTRUMENT_DUMP_JSON(_out) Instrumentation::dump_json(_out)
+#define INSTRUMENT_DUMP_CSV(_out) Instrumentation::dump_csv(_out)
+#define INSTRUMENT_RESET() Instrumentation::reset()
+
+#else
+
+#define INSTRUMENT_ADD(_name, _value) do {} while (0)
+#define INSTRUMENT_MAX(_name, _value) do {} while (0)
+#define INSTRUMENT_SCOPED_TIMER(_name)
+#define INSTRUMENT_SCOPED_DEPTH(_name)
+#define INSTRUMENT_DUMP_JSON(_out) do {} while (0)
+#define INSTRUMENT_DUMP_CSV(_out) do {} while (0)
+#define INSTRUMENT_RESET() do {} while (0)
+
+#endif
+
+#endif
@@ -0,0 +1,671 @@
+/*
+* Benchmark suite
+* Times Kosaraju's SCC algorithm, the Dijkstra variants, the heap variants, Karger-Stein's minimum cut and the sorting kernels
+* on seeded synthetic workloads: R-MAT (Kronecker) power-law graphs, 2-D grid road-like weighted graphs, Erdos-Renyi graphs
+* and random permutations.
+* Each benchmark prints one record (JSON line, or CSV row with --csv) with the median time, the throughput,
+* the percentile latencies and the peak RSS, so that two runs can be compared to catch performance regressions.
+*/
+
+/*
+* Usage: 009_benchmark_suite [--min-size N] [--max-size N] [--max-naive-size N] [--edge-factor N] [--repetitions N]
+*                            [--max-min-cut-size N] [--seed N] [--only scc|dijkstra|heap|min_cut|sort] [--external-memory BYTES] [--tmp-dir DIR]
+*                            [--reorder none|bfs|rcm|degree|gorder] [--threads N] [--csv]
+* Sizes go from --min-size to --max-size (default 10^3 to 10^6, up to 10^8), multiplied by 10 at each step.
+* The naive Dijkstra is in O(n*m), hence it is limited to --max-naive-size vertices (default 10^3). The heap Dijkstra runs at all sizes.
+* A Karger-Stein trial is in O(n^2 log(n)), hence it is limited to --max-min-cut-size vertexes (default 10^3).
+* With --reorder, the graphs are relabeled after construction (see 010_graph_vertex_reordering.hpp) and the relabeling is timed.
+* It includes storing the vertexes, the edges and their compact copy (CSR) in the new order; without it, the compact copy
+* is built with the graph.
+* The external heap runs with --external-memory (default 64MB), and as external_heap_min_spill with a budget of 1/16 of
+* the elements, so that it works on disk at all sizes (from 10 elements on).
+* The Kendall tau distance of two random rankings is timed through kendall_tau_distance (the merge sort counting inversions,
+* with --threads tasks, default 0: one per hardware thread). The other sorting kernels sort the ranks of one ranking in the
+* other, against std::sort.
+*
+* Remark: build with optimizations and threads, e.g. "g++ -std=c++11 -O2 -pthread 009_benchmark_suite.cpp".
+* Remark: on Linux, the peak RSS is reset before each benchmark (/proc/self/clear_refs), hence it is the high-water mark of the
+* benchmark alone (its input included). Elsewhere, it is the high-water mark of the whole process since its start.
+*/
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "004_graph_kosaraju_scc_algorithm.hpp"
+#include "005_dijkstra_shortest_path_algorithm.hpp"
+#include "006_heaps_template.hpp"
+#include "007_external_priority_queue.hpp"
+#include "010_graph_vertex_reordering.hpp"
+#include "011_karger_stein_min_cut.hpp"
+#include "013_sorting_kernels.hpp"
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <fstream>
+
+/*
+* ------------------ *
+* CLASS DECLARATIONS *
+* ------------------ *
+*/
+
+struct Benchmark_Options {
+	long long min_size;
+	long long max_size;
+	long long max_naive_size;
+	long long max_min_cut_size;
+	int edge_factor;
+	int repetitions;
+	unsigned long long seed;
+	std::string only;
+	size_t external_memory;
+	std::string tmp_dir;
+	std::string reorder;
+	int threads;
+	bool csv;
+
+	inline Benchmark_Options() : min_size(1000), max_size(1000000), max_naive_size(1000), max_min_cut_size(1000), edge_factor(8), repetitions(5),
+		seed(42), only(""), external_memory(64 << 20), tmp_dir("."), reorder("none"), threads(0), csv(false) {}
+};
+
+// An edge of a generated graph. Vertex indexes start at 1, as in the input files of the graph programs.
+struct Generated_Edge {
+	int tail;
+	int head;
+	int weight;
+};
+
+struct Generated_Graph {
+	int vertex_count;
+	std::vector<Generated_Edge> edges;
+};
+
+struct Benchmark_Result {
+	std::string benchmark;
+	std::string workload;
+	long long size;				// number of vertices, or of elements for the heaps
+	long long edges;
+	std::string unit;			// what the throughput counts
+	double items;				// number of units processed per repetition
+	std::vector<double> samples;		// time of each repetition, in seconds
+	std::vector<double> latencies;		// latencies used for the percentiles, in seconds
+};
+
+/*
+* ------------------ *
+* SYSTEM MEASUREMENT *
+* ------------------ *
+*/
+
+// Returns the peak resident set size of the process in kB
+size_t peak_rss_kb() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS _counters;
+	GetProcessMemoryInfo(GetCurrentProcess(), &_counters, sizeof(_counters));
+	return _counters.PeakWorkingSetSize / 1024;
+#else
+	struct rusage _usage;
+	getrusage(RUSAGE_SELF, &_usage);
+#ifdef __APPLE__
+	return _usage.ru_maxrss / 1024;		// bytes on macOS
+#else
+	return _usage.ru_maxrss;		// kB on Linux
+#endif
+#endif
+}
+
+// Makes the current RSS the peak RSS, so that the next measure only covers what follows (Linux only)
+void reset_peak_rss() {
+#ifdef __GLIBC__
+	// Give back to the system the memory freed by the previous benchmarks
+	malloc_trim(0);
+#endif
+#ifdef __linux__
+	std::ofstream _clear_refs("/proc/self/clear_refs");
+	_clear_refs << "5";
+#endif
+}
+
+inline double seconds_since(std::chrono::steady_clock::time_point _start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+}
+
+// Nearest-rank percentile of the given samples (_p in [0, 100])
+double percentile(std::vector<double> _samples, double _p) {
+	if (_samples.empty()) {
+		return 0;
+	}
+	std::sort(_samples.begin(), _samples.end());
+	size_t _rank = (size_t)std::ceil(_p / 100 * _samples.size());
+	return _samples[std::min(_samples.size() - 1, _rank == 0 ? 0 : _rank - 1)];
+}
+
+/*
+* ---------- *
+* GENERATORS *
+* ---------- *
+*/
+
+// R-MAT graph: each edge is drawn by recursively choosing one quadrant of the adjacency matrix with probabilities a, b, c, 1-a-b-c.
+// Vertex indexes are then shuffled so that the high degree vertices are not all at the beginning.
+Generated_Graph generate_rmat(int _vertex_count, long long _edge_count, unsigned long long _seed,
+	double _a = 0.57, double _b = 0.19, double _c = 0.19) {
+	std::mt19937_64 _rng(_seed);
+	std::uniform_real_distribution<double> _uniform(0, 1);
+	int _scale = 0;
+	while ((1LL << _scale) < _vertex_count) {
+		_scale++;
+	}
+
+	std::vector<int> _permutation(_vertex_count);
+	for (int i = 0; i < _vertex_count; i++) {
+		_permutation[i] = i + 1;
+	}
+	std::shuffle(_permutation.begin(), _permutation.end(), _rng);
+
+	Generated_Graph _graph;
+	_graph.vertex_count = _vertex_count;
+	_graph.edges.reserve(_edge_count);
+	while ((long long)_graph.edges.size() < _edge_count) {
+		long long _tail = 0;
+		long long _head = 0;
+		for (int _level = 0; _level < _scale; _level++) {
+			double _r = _uniform(_rng);
+			_tail <<= 1;
+			_head <<= 1;
+			if (_r < _a) {
+			}
+			else if (_r < _a + _b) {
+				_head |= 1;
+			}
+			else if (_r < _a + _b + _c) {
+				_tail |= 1;
+			}
+			else {
+				_tail |= 1;
+				_head |= 1;
+			}
+		}
+		// Reject the edges outside of the graph when the number of vertices is not a power of 2
+		if (_tail >= _vertex_count || _head >= _vertex_count) {
+			continue;
+		}
+		Generated_Edge _edge = { _permutation[_tail], _permutation[_head], 1 };
+		_graph.edges.push_back(_edge);
+	}
+	return _graph;
+}
+
+// Erdos-Renyi G(n, m) graph: m edges with uniformly drawn ends, without self-loops, weights in [1, 100]
+Generated_Graph generate_erdos_renyi(int _vertex_count, long long _edge_count, unsigned long long _seed) {
+	std::mt19937_64 _rng(_seed);
+	std::uniform_int_distribution<int> _vertex(1, _vertex_count);
+	std::uniform_int_distribution<int> _weight(1, 100);
+
+	Generated_Graph _graph;
+	_graph.vertex_count = _vertex_count;
+	_graph.edges.reserve(_edge_count);
+	while ((long long)_graph.edges.size() < _edge_count) {
+		Generated_Edge _edge = { _vertex(_rng), _vertex(_rng), _weight(_rng) };
+		if (_edge.tail != _edge.head) {
+			_graph.edges.push_back(_edge);
+		}
+	}
+	return _graph;
+}
+
+// Road-like graph: a square grid where each vertex is linked to its right and bottom neighbours, weights in [1, 100]
+Generated_Graph generate_grid(int _vertex_count, unsigned long long _seed) {
+	std::mt19937_64 _rng(_seed);
+	std::uniform_int_distribution<int> _weight(1, 100);
+	int _side = (int)std::ceil(std::sqrt((double)_vertex_count));
+
+	Generated_Graph _graph;
+	_graph.vertex_count = _side * _side;
+	_graph.edges.reserve(2 * (size_t)_side * _side);
+	for (int _row = 0; _row < _side; _row++) {
+		for (int _column = 0; _column < _side; _column++) {
+			int _index = _row * _side + _column + 1;
+			if (_column + 1 < _side) {
+				Generated_Edge _edge = { _index, _index + 1, _weight(_rng) };
+				_graph.edges.push_back(_edge);
+			}
+			if (_row + 1 < _side) {
+				Generated_Edge _edge = { _index, _index + _side, _weight(_rng) };
+				_graph.edges.push_back(_edge);
+			}
+		}
+	}
+	return _graph;
+}
+
+Generated_Graph generate(const std::string& _workload, long long _size, const Benchmark_Options& _options) {
+	if (_workload == "rmat") {
+		return generate_rmat((int)_size, _size * _options.edge_factor, _options.seed);
+	}
+	if (_workload == "erdos_renyi") {
+		return generate_erdos_renyi((int)_size, _size * _options.edge_factor, _options.seed);
+	}
+	return generate_grid((int)_size, _options.seed);
+}
+
+/*
+* -------------- *
+* GRAPH BUILDERS *
+* -------------- *
+*/
+
+// Builds the directed graph used by Kosaraju's algorithm
+Kosaraju::Graph* build_kosaraju_graph(const Generated_Graph& _generated) {
+	Kosaraju::Graph* g = new Kosaraju::Graph();
+	g->_vertexes.reserve(_generated.vertex_count);
+	for (int i = 0; i < _generated.vertex_count; i++) {
+		g->_vertexes.push_back(new Kosaraju::Vertex(i + 1));
+	}
+	g->_edges.reserve(_generated.edges.size());
+	for (const Generated_Edge& _e : _generated.edges) {
+		Kosaraju::Edge* edge = new Kosaraju::Edge(g->_vertexes[_e.head - 1], g->_vertexes[_e.tail - 1]);
+		g->_vertexes[_e.head - 1]->_in_edges.push_back(edge);
+		g->_vertexes[_e.tail - 1]->_out_edges.push_back(edge);
+		g->_edges.push_back(edge);
+	}
+	return g;
+}
+
+// Builds the undirected weighted graph used by Dijkstra's algorithm
+Dijkstra::Graph* build_dijkstra_graph(const Generated_Graph& _generated) {
+	Dijkstra::Graph* g = new Dijkstra::Graph();
+	g->m_vertexes.reserve(_generated.vertex_count);
+	for (int i = 0; i < _generated.vertex_count; i++) {
+		g->m_vertexes.push_back(new Dijkstra::Vertex(i + 1));
+	}
+	g->m_edges.reserve(_generated.edges.size());
+	for (const Generated_Edge& _e : _generated.edges) {
+		Dijkstra::Vertex* _tail = g->m_vertexes[_e.tail - 1];
+		Dijkstra::Vertex* _head = g->m_vertexes[_e.head - 1];
+		Dijkstra::Edge* _edge = new Dijkstra::Edge(_tail, _head, _e.weight);
+		_tail->m_in_edges.push_back(_edge);
+		_head->m_in_edges.push_back(_edge);
+		g->m_edges.push_back(_edge);
+	}
+	return g;
+}
+
+// Builds the compact edge array used by Karger-Stein's algorithm (self-loops are dropped)
+Karger::Graph* build_karger_graph(const Generated_Graph& _generated) {
+	Karger::Graph* g = new Karger::Graph();
+	g->m_vertex_count = _generated.vertex_count;
+	for (int i = 0; i < _generated.vertex_count; i++) {
+		g->m_indexes.push_back(i + 1);
+	}
+	g->m_edges.reserve(_generated.edges.size());
+	for (const Generated_Edge& _e : _generated.edges) {
+		if (_e.tail != _e.head) {
+			Karger::Edge _edge = { _e.tail - 1, _e.head - 1, 1 };
+			g->m_edges.push_back(_edge);
+		}
+	}
+	return g;
+}
+
+/*
+* ------ *
+* OUTPUT *
+* ------ *
+*/
+
+void print_header(const Benchmark_Options& _options) {
+	if (_options.csv) {
+		std::cout << "benchmark,workload,size,edges,seed,repetitions,median_seconds,throughput,unit,"
+			<< "latency_p50,latency_p90,latency_p99,latency_max,peak_rss_kb" << std::endl;
+	}
+}
+
+void print_result(const Benchmark_Result& _result, const Benchmark_Options& _options) {
+	double _median = percentile(_result.samples, 50);
+	double _throughput = _median > 0 ? _result.items / _median : 0;
+	const std::vector<double>& _latencies = _result.latencies.empty() ? _result.samples : _result.latencies;
+	if (_options.csv) {
+		std::cout << _result.benchmark << "," << _result.workload << "," << _result.size << "," << _result.edges << ","
+			<< _options.seed << "," << _result.samples.size() << "," << _median << "," << _throughput << "," << _result.unit << ","
+			<< percentile(_latencies, 50) << "," << percentile(_latencies, 90) << "," << percentile(_latencies, 99) << ","
+			<< percentile(_latencies, 100) << "," << peak_rss_kb() << std::endl;
+	}
+	else {
+		std::cout << "{\"benchmark\": \"" << _result.benchmark << "\", \"workload\": \"" << _result.workload
+			<< "\", \"size\": " << _result.size << ", \"edges\": " << _result.edges << ", \"seed\": " << _options.seed
+			<< ", \"repetitions\": " << _result.samples.size() << ", \"median_seconds\": " << _median
+			<< ", \"throughput\": " << _throughput << ", \"unit\": \"" << _result.unit << "\""
+			<< ", \"latency_p50\": " << percentile(_latencies, 50) << ", \"latency_p90\": " << percentile(_latencies, 90)
+			<< ", \"latency_p99\": " << percentile(_latencies, 99) << ", \"latency_max\": " << percentile(_latencies, 100)
+			<< ", \"peak_rss_kb\": " << peak_rss_kb() << "}" << std::endl;
+	}
+}
+
+/*
+* ---------- *
+* BENCHMARKS *
+* ---------- *
+*/
+
+// Kosaraju's SCC: graph construction, then both DFS passes
+void benchmark_scc(const std::string& _workload, long long _size, const Benchmark_Options& _options) {
+	reset_peak_rss();
+	Generated_Graph _generated = generate(_workload, _size, _options);
+
+	Benchmark_Result _build = { "kosaraju_scc_build", _workload, _generated.vertex_count, (long long)_generated.edges.size(), "edges/s",
+		(double)_generated.edges.size() };
+	Benchmark_Result _reorder = _build;
+	_reorder.benchmark = "kosaraju_scc_reorder_" + _options.reorder;
+	Benchmark_Result _scc = _build;
+	_scc.benchmark = "kosaraju_scc";
+
+	for (int _repetition = 0; _repetition < _options.repetitions; _repetition++) {
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		Kosaraju::Graph* g = build_kosaraju_graph(_generated);
+		// The compact edges of the DFS are part of the build, unless the relabeling builds them in the new order
+		if (_options.reorder == "none") {
+			g->Compact();
+		}
+		_build.samples.push_back(seconds_since(_start));
+
+		if (_options.reorder != "none") {
+			// The adjacency lists are freed before the relabeling
+			_start = std::chrono::steady_clock::now();
+			std::vector<int> _order = make_ordering(_options.reorder, g->GetAdjacency());
+			g->Reorder(_order);
+			_reorder.samples.push_back(seconds_since(_start));
+		}
+
+		_start = std::chrono::steady_clock::now();
+		Kosaraju::DFS_handler _handler(g);
+		_handler.DFS_Loop_Reversed();
+		_handler.DFS_Loop_SCC();
+		_scc.samples.push_back(seconds_since(_start));
+
+		delete g;
+	}
+	print_result(_build, _options);
+	if (_options.reorder != "none") {
+		print_result(_reorder, _options);
+	}
+	print_result(_scc, _options);
+}
+
+// Dijkstra's shortest paths from a random source (one source per repetition)
+void benchmark_dijkstra(const std::string& _workload, long long _size, const Benchmark_Options& _options) {
+	reset_peak_rss();
+	Generated_Graph _generated = generate(_workload, _size, _options);
+	Dijkstra::Graph* g = build_dijkstra_graph(_generated);
+	// The graph is built, relabeled and compacted once for all the sources
+	if (_options.reorder != "none") {
+		Benchmark_Result _reorder = { "dijkstra_reorder_" + _options.reorder, _workload, _generated.vertex_count,
+			(long long)_generated.edges.size(), "edges/s", (double)_generated.edges.size() };
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		std::vector<int> _order = make_ordering(_options.reorder, g->GetAdjacency());
+		g->Reorder(_order);
+		_reorder.samples.push_back(seconds_since(_start));
+		print_result(_reorder, _options);
+	}
+	g->Compact();
+	std::mt19937_64 _rng(_options.seed);
+	std::uniform_int_distribution<int> _source(0, _generated.vertex_count - 1);
+
+	if (_size <= _options.max_naive_size) {
+		Benchmark_Result _naive = { "dijkstra_naive", _workload, _generated.vertex_count, (long long)_generated.edges.size(), "edges/s",
+			(double)_generated.edges.size() };
+		for (int _repetition = 0; _repetition < _options.repetitions; _repetition++) {
+			std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+			Dijkstra::DSP_handler_naive _handler(g, g->m_vertexes[_source(_rng)]);
+			_handler.run();
+			_naive.samples.push_back(seconds_since(_start));
+		}
+		print_result(_naive, _options);
+	}
+
+	// The buffers of the handler are reused from one source to the next, as in the query server
+	Benchmark_Result _heap = { "dijkstra_heap", _workload, _generated.vertex_count, (long long)_generated.edges.size(), "edges/s",
+		(double)_generated.edges.size() };
+	Dijkstra::DSP_handler_heap _handler(g);
+	for (int _repetition = 0; _repetition < _options.repetitions; _repetition++) {
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		_handler.run(g->m_vertexes[_source(_rng)]);
+		_heap.samples.push_back(seconds_since(_start));
+	}
+	print_result(_heap, _options);
+	delete g;
+}
+
+// One Karger-Stein trial per repetition (the number of trials needed only depends on the confidence)
+void benchmark_min_cut(const std::string& _workload, long long _size, const Benchmark_Options& _options) {
+	reset_peak_rss();
+	Generated_Graph _generated = generate(_workload, _size, _options);
+	Karger::Graph* g = build_karger_graph(_generated);
+	Karger::Min_Cut_worker _worker(_options.seed, 0);
+
+	Benchmark_Result _trial = { "karger_stein_trial", _workload, g->m_vertex_count, (long long)g->m_edges.size(), "trials/s", 1 };
+	for (int _repetition = 0; _repetition < _options.repetitions; _repetition++) {
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		_worker.karger_stein(*g);
+		_trial.samples.push_back(seconds_since(_start));
+	}
+	print_result(_trial, _options);
+	delete g;
+}
+
+// Pushes _size random elements then pops them all. Latencies are the mean time per operation over batches of operations.
+template <typename Queue>
+void benchmark_queue(const std::string& _name, Queue* (*_create)(long long, const Benchmark_Options&), long long _size, const Benchmark_Options& _options) {
+	reset_peak_rss();
+	const long long _batch = 1024;
+	std::mt19937_64 _rng(_options.seed);
+	std::uniform_int_distribution<int> _value(0, std::numeric_limits<int>::max());
+	std::vector<int> _values(_size);
+	for (long long i = 0; i < _size; i++) {
+		_values[i] = _value(_rng);
+	}
+
+	Benchmark_Result _result = { _name, "uniform", _size, 0, "operations/s", 2.0 * _size };
+	for (int _repetition = 0; _repetition < _options.repetitions; _repetition++) {
+		Queue* _queue = _create(_size, _options);
+		std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+		for (long long i = 0; i < _size; i += _batch) {
+			std::chrono::steady_clock::time_point _batch_start = std::chrono::steady_clock::now();
+			long long _end = std::min(_size, i + _batch);
+			for (long long j = i; j < _end; j++) {
+				_queue->push(_values[j]);
+			}
+			_result.latencies.push_back(seconds_since(_batch_start) / (_end - i));
+		}
+		for (long long i = 0; i < _size; i += _batch) {
+			std::chrono::steady_clock::time_point _batch_start = std::chrono::steady_clock::now();
+			long long _end = std::min(_size, i + _batch);
+			for (long long j = i; j < _end; j++) {
+				_queue->pop();
+			}
+			_result.latencies.push_back(seconds_since(_batch_start) / (_end - i));
+		}
+		_result.samples.push_back(seconds_since(_start));
+		delete _queue;
+	}
+	print_result(_result, _options);
+}
+
+// Sorts the ranks in a second random ranking of the items of a first one (the inversions are the Kendall tau distance)
+void benchmark_sort(long long _size, const Benchmark_Options& _options) {
+	std::mt19937_64 _rng(_options.seed);
+	std::vector<int> _ranking1(_size);
+	for (long long i = 0; i < _size; i++) {
+		_ranking1[i] = (int)i;
+	}
+	std::shuffle(_ranking1.begin(), _ranking1.end(), _rng);
+	std::vector<int> _ranking2 = _ranking1;
+	std::shuffle(_ranking2.begin(), _ranking2.end(), _rng);
+
+	// The merge sort runs through kendall_tau_distance, that allocates its buffers at each call
+	{
+		reset_peak_rss();
+		Benchmark_Result _result = { "kendall_tau_distance", "permutation", _size, 0, "elements/s", (double)_size };
+		for (int _repetition = 0; _repetition < _options.repetitions; _repetition++) {
+			std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+			Sorting::kendall_tau_distance(_ranking1, _ranking2, _options.threads);
+			_result.samples.push_back(seconds_since(_start));
+		}
+		print_result(_result, _options);
+	}
+
+	// The other kernels sort the ranks in the second ranking of the items of the first one
+	std::vector<int> _rank(_size);
+	for (long long i = 0; i < _size; i++) {
+		_rank[_ranking2[i]] = (int)i;
+	}
+	std::vector<int> _ranks(_size);
+	for (long long i = 0; i < _size; i++) {
+		_ranks[i] = _rank[_ranking1[i]];
+	}
+
+	// The copy of the input is not timed
+	std::vector<int> _array;
+	auto _run = [&](const std::string& _name, std::function<void(std::vector<int>&)> _sort) {
+		reset_peak_rss();
+		Benchmark_Result _result = { _name, "permutation", _size, 0, "elements/s", (double)_size };
+		for (int _repetition = 0; _repetition < _options.repetitions; _repetition++) {
+			_array = _ranks;
+			std::chrono::steady_clock::time_point _start = std::chrono::steady_clock::now();
+			_sort(_array);
+			_result.samples.push_back(seconds_since(_start));
+		}
+		print_result(_result, _options);
+	};
+
+	const char* _rules[] = { "first", "last", "median_of_three", "ninther" };
+	for (const char* _rule : _rules) {
+		Sorting::Quick_Sort_handler<int> _quick_sort(Sorting::make_pivot_rule(_rule));
+		_run(std::string("quick_sort_") + _rule, [&](std::vector<int>& _v) { _quick_sort.run(_v); });
+	}
+	_run("std_sort", [](std::vector<int>& _v) { std::sort(_v.begin(), _v.end()); });
+}
+
+Heap_Min<int>* create_heap_min(long long, const Benchmark_Options&) { return new Heap_Min<int>(); }
+Heap_Max<int>* create_heap_max(long long, const Benchmark_Options&) { return new Heap_Max<int>(); }
+External_Heap_Min<int>* create_external_heap_min(long long, const Benchmark_Options& _options) {
+	return new External_Heap_Min<int>(_options.external_memory, 1 << 20, _options.tmp_dir);
+}
+// Budget of 1/16 of the elements and 32 blocks (of at least one element), so that the runs on disk are always used and merged
+External_Heap_Min<int>* create_external_heap_min_spill(long long _size, const Benchmark_Options& _options) {
+	size_t _budget = std::max<size_t>(32 * sizeof(int), _size * sizeof(int) / 16);
+	return new External_Heap_Min<int>(_budget, _budget / 32, _options.tmp_dir);
+}
+
+/*
+* ---- *
+* MAIN *
+* ---- *
+*/
+
+int main(int argc, char** argv) {
+	Benchmark_Options _options;
+	for (int i = 1; i < argc; i++) {
+		std::string _argument = argv[i];
+		if (_argument == "--csv") {
+			_options.csv = true;
+			continue;
+		}
+		if (i + 1 >= argc) {
+			std::cerr << "Missing value for " << _argument << std::endl;
+			return 1;
+		}
+		std::string _value = argv[++i];
+		if (_argument == "--min-size") {
+			_options.min_size = std::stoll(_value);
+		}
+		else if (_argument == "--max-size") {
+			_options.max_size = std::stoll(_value);
+		}
+		else if (_argument == "--max-naive-size") {
+			_options.max_naive_size = std::stoll(_value);
+		}
+		else if (_argument == "--max-min-cut-size") {
+			_options.max_min_cut_size = std::stoll(_value);
+		}
+		else if (_argument == "--edge-factor") {
+			_options.edge_factor = std::stoi(_value);
+		}
+		else if (_argument == "--repetitions") {
+			_options.repetitions = std::stoi(_value);
+		}
+		else if (_argument == "--seed") {
+			_options.seed = std::stoull(_value);
+		}
+		else if (_argument == "--only") {
+			_options.only = _value;
+		}
+		else if (_argument == "--external-memory") {
+			_options.external_memory = std::stoull(_value);
+			// External_Heap_Min needs at least 7 blocks, of 1MB here
+			if (_options.external_memory < (7 << 20)) {
+				std::cerr << "--external-memory must be at least " << (7 << 20) << std::endl;
+				return 1;
+			}
+		}
+		else if (_argument == "--tmp-dir") {
+			_options.tmp_dir = _value;
+		}
+		else if (_argument == "--reorder") {
+			_options.reorder = _value;
+			try {
+				make_ordering(_value, Adjacency());
+			}
+			catch (const std::invalid_argument& e) {
+				std::cerr << e.what() << std::endl;
+				return 1;
+			}
+		}
+		else if (_argument == "--threads") {
+			_options.threads = std::stoi(_value);
+		}
+		else {
+			std::cerr << "Unknown option " << _argument << std::endl;
+			return 1;
+		}
+	}
+
+	print_header(_options);
+	for (long long _size = _options.min_size; _size <= _options.max_size; _size *= 10) {
+		if (_options.only.empty() || _options.only == "scc") {
+			benchmark_scc("rmat", _size, _options);
+			benchmark_scc("erdos_renyi", _size, _options);
+		}
+		if (_options.only.empty() || _options.only == "dijkstra") {
+			benchmark_dijkstra("grid", _size, _options);
+			benchmark_dijkstra("erdos_renyi", _size, _options);
+		}
+		if (_options.only.empty() || _options.only == "heap") {
+			benchmark_queue("heap_min", &create_heap_min, _size, _options);
+			benchmark_queue("heap_max", &create_heap_max, _size, _options);
+			benchmark_queue("external_heap_min", &create_external_heap_min, _size, _options);
+			benchmark_queue("external_heap_min_spill", &create_external_heap_min_spill, _size, _options);
+		}
+		if ((_options.only.empty() || _options.only == "min_cut") && _size <= _options.max_min_cut_size) {
+			benchmark_min_cut("erdos_renyi", _size, _options);
+		}
+		if (_options.only.empty() || _options.only == "sort") {
+			benchmark_sort(_size, _options);
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,296 @@
+/*
+* Vertex reordering
+* Implements orderings of the vertexes of a graph that place the vertexes visited together next to each other,
+* so that the graph traversals (DFS, shortest paths) make fewer cache and TLB misses:
+*	- "bfs": breadth-first search order,
+*	- "rcm": reverse Cuthill-McKee order (BFS from a low degree vertex, neighbours by increasing degree, reversed),
+*	- "degree": decreasing degree order (the hubs are packed together),
+*	- "gorder": greedy Gorder-style order (the next vertex is the one sharing the most neighbours with the last placed ones).
+* An ordering is a vector such that order[new position] = old position. It is applied with Graph::Reorder, that stores
+* the vertexes, the edges and their compact copy contiguously in the new order. The vertexes keep their index from the
+* input file so that results can be reported with the original ids.
+*/
+
+/*
+* Usage:
+*	std::vector<int> _order = make_ordering("rcm", g->GetAdjacency());
+*	g->Reorder(_order);
+*	std::vector<int> _position = invert_ordering(_order);	// old position -> new position, to find the vertexes by id
+*/
+
+#ifndef GRAPH_VERTEX_REORDERING_H
+#define GRAPH_VERTEX_REORDERING_H
+
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+// Undirected adjacency lists: for each vertex position, the positions of its neighbours
+typedef std::vector<std::vector<int> > Adjacency;
+
+/*
+* ------------------ *
+* CLASS DECLARATIONS *
+* ------------------ *
+*/
+
+/*
+* Max priority queue of the vertex scores of Gorder. Scores only change by +1 or -1, hence the vertexes are kept in
+* doubly linked lists, one per score, and every operation is in O(1) (amortized for pop).
+*/
+class Unit_Heap {
+public:
+	inline Unit_Heap(size_t n) : m_score(n, 0), m_previous(n, -1), m_next(n, -1), m_head(16, -1), m_top(0) {}
+
+	void increment(int);
+	void decrement(int);
+	void remove(int);					// removes the vertex for good (it has been placed)
+	int pop();						// removes and returns the vertex of highest positive score, -1 if none
+	inline bool placed(int _vertex) { return m_score[_vertex] < 0; }
+
+private:
+	std::vector<int> m_score;				// -1 once removed
+	std::vector<int> m_previous;
+	std::vector<int> m_next;
+	std::vector<int> m_head;				// first vertex of each score, -1 if none
+	int m_top;						// upper bound of the highest score
+
+	void link(int);
+	void unlink(int);
+};
+
+/*
+* ---------------------- *
+* FUNCTIONS DECLARATIONS *
+* ---------------------- *
+*/
+
+std::vector<int> order_identity(const Adjacency&);
+std::vector<int> order_bfs(const Adjacency&);
+std::vector<int> order_rcm(const Adjacency&);
+std::vector<int> order_degree(const Adjacency&);
+std::vector<int> order_gorder(const Adjacency&, int _window = 5);
+std::vector<int> make_ordering(const std::string&, const Adjacency&);	// given a name ("none", "bfs", "rcm", "degree", "gorder"), computes the ordering, throws std::invalid_argument for other names
+std::vector<int> invert_ordering(const std::vector<int>&);		// new -> old becomes old -> new
+
+/*
+* ------------------------- *
+* FUNCTIONS IMPLEMENTATIONS *
+* ------------------------- *
+*/
+
+inline std::vector<int> order_identity(const Adjacency& _adjacency) {
+	std::vector<int> _order(_adjacency.size());
+	for (size_t i = 0; i < _order.size(); i++) {
+		_order[i] = (int)i;
+	}
+	return _order;
+}
+
+inline std::vector<int> order_bfs(const Adjacency& _adjacency) {
+	std::vector<int> _order;
+	_order.reserve(_adjacency.size());
+	std::vector<bool> _visited(_adjacency.size(), false);
+	for (size_t _start = 0; _start < _adjacency.size(); _start++) {
+		if (_visited[_start]) {
+			continue;
+		}
+		// The order vector is the BFS queue itself
+		size_t _head = _order.size();
+		_visited[_start] = true;
+		_order.push_back((int)_start);
+		while (_head < _order.size()) {
+			int _vertex = _order[_head++];
+			for (int _neighbour : _adjacency[_vertex]) {
+				if (!_visited[_neighbour]) {
+					_visited[_neighbour] = true;
+					_order.push_back(_neighbour);
+				}
+			}
+		}
+	}
+	return _order;
+}
+
+inline std::vector<int> order_rcm(const Adjacency& _adjacency) {
+	size_t n = _adjacency.size();
+	std::vector<int> _order;
+	_order.reserve(n);
+	std::vector<bool> _visited(n, false);
+
+	// Components are started from their vertex of lowest degree
+	std::vector<int> _by_degree = order_identity(_adjacency);
+	std::stable_sort(_by_degree.begin(), _by_degree.end(), [&](int a, int b) { return _adjacency[a].size() < _adjacency[b].size(); });
+
+	std::vector<int> _neighbours;
+	for (int _start : _by_degree) {
+		if (_visited[_start]) {
+			continue;
+		}
+		size_t _head = _order.size();
+		_visited[_start] = true;
+		_order.push_back(_start);
+		while (_head < _order.size()) {
+			int _vertex = _order[_head++];
+			_neighbours.clear();
+			for (int _neighbour : _adjacency[_vertex]) {
+				if (!_visited[_neighbour]) {
+					_visited[_neighbour] = true;
+					_neighbours.push_back(_neighbour);
+				}
+			}
+			std::stable_sort(_neighbours.begin(), _neighbours.end(), [&](int a, int b) { return _adjacency[a].size() < _adjacency[b].size(); });
+			_order.insert(_order.end(), _neighbours.begin(), _neighbours.end());
+		}
+	}
+	std::reverse(_order.begin(), _order.end());
+	return _order;
+}
+
+inline std::vector<int> order_degree(const Adjacency& _adjacency) {
+	std::vector<int> _order = order_identity(_adjacency);
+	std::stable_sort(_order.begin(), _order.end(), [&](int a, int b) { return _adjacency[a].size() > _adjacency[b].size(); });
+	return _order;
+}
+
+inline void Unit_Heap::increment(int _vertex) {
+	unlink(_vertex);
+	m_score[_vertex]++;
+	link(_vertex);
+}
+
+inline void Unit_Heap::decrement(int _vertex) {
+	unlink(_vertex);
+	m_score[_vertex]--;
+	link(_vertex);
+}
+
+inline void Unit_Heap::remove(int _vertex) {
+	unlink(_vertex);
+	m_score[_vertex] = -1;
+}
+
+inline int Unit_Heap::pop() {
+	while (m_top > 0 && m_head[m_top] == -1) {
+		m_top--;
+	}
+	if (m_top == 0) {
+		return -1;
+	}
+	int _vertex = m_head[m_top];
+	remove(_vertex);
+	return _vertex;
+}
+
+inline void Unit_Heap::link(int _vertex) {
+	int _score = m_score[_vertex];
+	if (_score <= 0) {
+		return;
+	}
+	if (_score >= (int)m_head.size()) {
+		m_head.resize(2 * _score, -1);
+	}
+	m_previous[_vertex] = -1;
+	m_next[_vertex] = m_head[_score];
+	if (m_head[_score] != -1) {
+		m_previous[m_head[_score]] = _vertex;
+	}
+	m_head[_score] = _vertex;
+	m_top = std::max(m_top, _score);
+}
+
+inline void Unit_Heap::unlink(int _vertex) {
+	int _score = m_score[_vertex];
+	if (_score <= 0) {
+		return;
+	}
+	if (m_previous[_vertex] != -1) {
+		m_next[m_previous[_vertex]] = m_next[_vertex];
+	}
+	else {
+		m_head[_score] = m_next[_vertex];
+	}
+	if (m_next[_vertex] != -1) {
+		m_previous[m_next[_vertex]] = m_previous[_vertex];
+	}
+}
+
+inline std::vector<int> order_gorder(const Adjacency& _adjacency, int _window) {
+	size_t n = _adjacency.size();
+	std::vector<int> _order;
+	_order.reserve(n);
+	// Score of a vertex: number of neighbours and siblings among the vertexes of the window
+	Unit_Heap _candidates(n);
+	// The siblings of a hub are not scored: it would cost O(degree^2) for little locality
+	size_t _hub_degree = (size_t)std::sqrt((double)n) + 1;
+
+	std::vector<int> _by_degree = order_degree(_adjacency);
+	size_t _next_unplaced = 0;
+
+	// Increments (resp. decrements) the score of the vertexes related to _vertex
+	auto _update = [&](int _vertex, bool _increment) {
+		for (int _neighbour : _adjacency[_vertex]) {
+			if (!_candidates.placed(_neighbour)) {
+				_increment ? _candidates.increment(_neighbour) : _candidates.decrement(_neighbour);
+			}
+			if (_adjacency[_neighbour].size() > _hub_degree) {
+				continue;
+			}
+			for (int _sibling : _adjacency[_neighbour]) {
+				if (_sibling != _vertex && !_candidates.placed(_sibling)) {
+					_increment ? _candidates.increment(_sibling) : _candidates.decrement(_sibling);
+				}
+			}
+		}
+	};
+
+	while (_order.size() < n) {
+		int _next = _candidates.pop();
+		// No related vertex: start again from the unplaced vertex of highest degree
+		if (_next == -1) {
+			while (_candidates.placed(_by_degree[_next_unplaced])) {
+				_next_unplaced++;
+			}
+			_next = _by_degree[_next_unplaced];
+			_candidates.remove(_next);
+		}
+
+		_order.push_back(_next);
+		_update(_next, true);
+		if ((int)_order.size() > _window) {
+			_update(_order[_order.size() - 1 - _window], false);
+		}
+	}
+	return _order;
+}
+
+inline std::vector<int> make_ordering(const std::string& _name, const Adjacency& _adjacency) {
+	if (_name == "bfs") {
+		return order_bfs(_adjacency);
+	}
+	if (_name == "rcm") {
+		return order_rcm(_adjacency);
+	}
+	if (_name == "degree") {
+		return order_degree(_adjacency);
+	}
+	if (_name == "gorder") {
+		return order_gorder(_adjacency);
+	}
+	if (_name == "none") {
+		return order_identity(_adjacency);
+	}
+	throw std::invalid_argument("Unknown ordering " + _name);
+}
+
+inline std::vector<int> invert_ordering(const std::vector<int>& _order) {
+	std::vector<int> _position(_order.size());
+	for (size_t i = 0; i < _order.size(); i++) {
+		_position[_order[i]] = (int)i;
+	}
+	return _position;
+}
+
+#endif
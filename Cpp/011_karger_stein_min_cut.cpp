@@ -0,0 +1,102 @@
+/*
+* Karger-Stein random minimum cut
+* This file computes the minimum cut of an undirected graph with Karger-Stein's recursive random contraction,
+* running the trials in parallel (see 011_karger_stein_min_cut.hpp).
+*/
+
+/*
+* Remark: requires C++11 threads (e.g. "g++ -std=c++11 -O2 -pthread").
+*/
+
+// The input file "kargerMinCut.txt" is formatted as in Python/003_random_graph_min_cut.py: a set of lines,
+// each line beginning with the index of a vertex followed by the indexes of the vertexes it shares an edge with.
+// For instance: "1 3 4" means that vertex 1 is linked to vertexes 3 and 4. Each edge appears on the lines of both ends.
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <map>
+#include "011_karger_stein_min_cut.hpp"
+
+using namespace Karger;
+
+/*
+* ---- *
+* MAIN *
+* ---- *
+*/
+
+int main() {
+	// The input file "kargerMinCut.txt" is formatted as a set of lines
+	// Each line begins with the index of a vertex, followed by the indexes of its neighbours
+	std::ifstream myfile("kargerMinCut.txt");
+	double confidence = 0.99; // for instance
+	std::string* line = new std::string();
+
+	if (myfile.is_open()) {
+
+		Graph* g = new Graph();
+		{
+			INSTRUMENT_SCOPED_TIMER("min_cut.load");
+			// Read the adjacency lists, vertexes get positions in the order of the file
+			std::vector<std::vector<int> > _adjacency;
+			std::map<int, int> _position;
+			while (std::getline(myfile, *line)) {
+				std::istringstream iss(*line);
+				int _index;
+				if (!(iss >> _index)) {
+					continue;
+				}
+				_position[_index] = (int)g->m_indexes.size();
+				g->m_indexes.push_back(_index);
+				_adjacency.push_back(std::vector<int>());
+				int _neighbour;
+				while (iss >> _neighbour) {
+					_adjacency.back().push_back(_neighbour);
+				}
+			}
+			myfile.close();
+			delete line;
+
+			// Creating the graph: each edge is kept once, from its end of lowest index
+			g->m_vertex_count = (int)g->m_indexes.size();
+			for (int i = 0; i < g->m_vertex_count; i++) {
+				for (int _neighbour : _adjacency[i]) {
+					std::map<int, int>::iterator _other = _position.find(_neighbour);
+					if (_other == _position.end()) {
+						std::cout << "Vertex " << _neighbour << " has no line of its own!" << std::endl;
+						return 1;
+					}
+					if (g->m_indexes[i] < _neighbour) {
+						Edge _edge = { i, _other->second, 1 };
+						g->m_edges.push_back(_edge);
+					}
+				}
+			}
+		}
+
+		std::cout << "Graph created. Size: " << g->m_vertex_count << ", edges: " << g->m_edges.size() << std::endl;
+
+		Min_Cut_handler* _min_cut = new Min_Cut_handler(g, confidence);
+		{
+			INSTRUMENT_SCOPED_TIMER("min_cut.run");
+			_min_cut->run();
+		}
+
+		std::cout << "Minimum cut: " << _min_cut->getMinCut() << " (" << _min_cut->getTrials() << " trials, probability of success >= "
+			<< confidence << ")" << std::endl;
+
+		INSTRUMENT_DUMP_JSON(std::cerr);
+
+		delete _min_cut;
+		delete g;
+	}
+	else {
+		std::cout << "Unable to read file!" << std::endl;
+	}
+
+	system("pause");
+
+	return 0;
+}
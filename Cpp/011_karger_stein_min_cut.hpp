@@ -0,0 +1,344 @@
+/*
+* Karger-Stein random minimum cut
+* This file implements the minimum cut of an undirected graph by random contraction. The graph is a compact array of
+* weighted edges, and a contraction merges the ends of the edges taken in a random order with a union-find, until the
+* target number of vertexes is reached. The parallel edges of the contracted graph are then merged into one weighted edge.
+* Drawing the edges by increasing exponential clocks of rate the weight is the same as drawing a uniform edge of the multigraph.
+* Karger-Stein's algorithm contracts the graph down to n / sqrt(2) vertexes twice, and recurses on both contracted graphs.
+* One trial finds the minimum cut with probability at least 1 / (2 log2(n)), against 2 / n^2 for Karger's algorithm
+* (contract down to 2 vertexes).
+* Trials are run in parallel, each thread having its own random generator, until the probability of NOT finding the
+* minimum cut is below 1 - confidence.
+*/
+
+/*
+* Remark: a trial is in O(n^2 log(n)) whatever the number of edges, since the contracted graphs become dense, and
+* about 2 log2(n) ln(1 / (1 - confidence)) trials are needed, hence O(n^2 log^2(n)) in total, divided by the number of
+* threads. On one thread of the sparse Erdos-Renyi graphs of the benchmark (8 edges per vertex), a trial takes 0.3s for
+* 500 vertexes, 1.3s for 1000 and 9.7s for 3000; the 107 trials of the latter at 0.99 take about 17 minutes. The 200
+* vertexes of kargerMinCut.txt take 4.4s (71 trials).
+*/
+
+#ifndef KARGER_STEIN_MIN_CUT_H
+#define KARGER_STEIN_MIN_CUT_H
+
+#include <vector>
+#include <deque>
+#include <random>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "008_instrumentation.hpp"
+
+namespace Karger {
+
+/*
+* ------------------ *
+* CLASS DECLARATIONS *
+* ------------------ *
+*/
+
+// An undirected edge between two vertex positions (from 0 to n - 1), the weight being the number of parallel edges
+struct Edge {
+	int m_vertex1;
+	int m_vertex2;
+	int m_weight;
+};
+
+class Graph {
+public:
+	int m_vertex_count;
+	std::vector<Edge> m_edges;
+	std::vector<int> m_indexes;				// the index from the input file of each vertex position
+
+	inline Graph() : m_vertex_count(0) {}
+};
+
+class Union_Find {
+public:
+	void reset(int);					// n singletons
+	int find(int);						// returns the representative of the set of the given element
+	bool unite(int, int);					// merges the sets of both elements, false if already merged
+	inline int components() { return m_components; }
+
+private:
+	std::vector<int> m_parent;
+	std::vector<int> m_rank;
+	int m_components;
+};
+
+/*
+* Runs trials on one thread. The scratch buffers of each recursion depth are kept between the trials.
+*/
+class Min_Cut_worker {
+public:
+	inline Min_Cut_worker(unsigned long long _seed, unsigned long long _stream) {
+		std::seed_seq _seeds = { (unsigned int)_seed, (unsigned int)(_seed >> 32), (unsigned int)_stream };
+		m_rng.seed(_seeds);
+	}
+
+	int karger(const Graph&);				// one trial of Karger's algorithm, returns the cut found
+	int karger_stein(const Graph&);				// one trial of Karger-Stein's algorithm, returns the cut found
+
+private:
+	std::mt19937_64 m_rng;
+	std::deque<std::vector<Edge> > m_levels;		// contracted edges of each depth
+	// Scratch buffers of a contraction, shared by all depths
+	std::vector<std::pair<double, int> > m_clocks;		// (firing time, edge), as a min heap
+	std::vector<int> m_labels;
+	std::vector<int> m_bucket_start;			// counting sort of the contracted edges by first end
+	std::vector<Edge> m_bucketed;
+	std::vector<int> m_last_seen;				// for each second end, the last first end seen with it
+	std::vector<int> m_last_position;
+	Union_Find m_union_find;
+
+	int contract(const std::vector<Edge>&, int, int, int);	// contracts (edges, n) down to t vertexes in m_levels[depth + 1], returns its vertex count, -1 if disconnected
+	int recurse(const std::vector<Edge>&, int, int);	// Karger-Stein on (edges, n) at the given depth
+	int exhaustive(const std::vector<Edge>&, int);		// exact minimum cut of a graph with few vertexes
+	void reserve(int);					// makes sure the scratch buffers of the given depth exist
+};
+
+class Min_Cut_handler {
+public:
+	Graph* m_graph;
+	double m_confidence;					// target probability of finding the minimum cut
+	int m_threads;						// 0: one per hardware thread
+	unsigned long long m_seed;
+	bool m_recursive;					// Karger-Stein (true) or Karger (false)
+
+	inline Min_Cut_handler(Graph* _g, double _confidence = 0.99, int _threads = 0, unsigned long long _seed = 42, bool _recursive = true) :
+		m_graph(_g), m_confidence(_confidence), m_threads(_threads), m_seed(_seed), m_recursive(_recursive),
+		m_min_cut(std::numeric_limits<int>::max()), m_trials(0), m_target_trials(0) {}
+	void run();
+
+	inline int getMinCut() { return m_min_cut; }
+	inline long long getTrials() { return m_trials; }		// number of trials actually run
+	inline long long getTargetTrials() { return m_target_trials; }	// number of trials needed for the confidence
+
+private:
+	int m_min_cut;
+	long long m_trials;
+	long long m_target_trials;
+};
+
+/*
+* ----------------------- *
+* METHODS IMPLEMENTATIONS *
+* ----------------------- *
+*/
+
+inline void Union_Find::reset(int n) {
+	m_parent.resize(n);
+	m_rank.assign(n, 0);
+	for (int i = 0; i < n; i++) {
+		m_parent[i] = i;
+	}
+	m_components = n;
+}
+
+inline int Union_Find::find(int i) {
+	// Path halving
+	while (m_parent[i] != i) {
+		m_parent[i] = m_parent[m_parent[i]];
+		i = m_parent[i];
+	}
+	return i;
+}
+
+inline bool Union_Find::unite(int i, int j) {
+	i = find(i);
+	j = find(j);
+	if (i == j) {
+		return false;
+	}
+	if (m_rank[i] < m_rank[j]) {
+		std::swap(i, j);
+	}
+	m_parent[j] = i;
+	if (m_rank[i] == m_rank[j]) {
+		m_rank[i]++;
+	}
+	m_components--;
+	return true;
+}
+
+inline void Min_Cut_worker::reserve(int _depth) {
+	while ((int)m_levels.size() <= _depth + 1) {
+		m_levels.push_back(std::vector<Edge>());
+	}
+}
+
+inline int Min_Cut_worker::contract(const std::vector<Edge>& _edges, int n, int t, int _depth) {
+	reserve(_depth);
+	m_union_find.reset(n);
+
+	// Merge the ends of the edges by increasing firing time, until t vertexes remain
+	std::exponential_distribution<double> _clock;
+	m_clocks.clear();
+	for (size_t i = 0; i < _edges.size(); i++) {
+		m_clocks.push_back(std::make_pair(_clock(m_rng) / _edges[i].m_weight, (int)i));
+	}
+	std::greater<std::pair<double, int> > _later;
+	std::make_heap(m_clocks.begin(), m_clocks.end(), _later);
+	while (m_union_find.components() > t && !m_clocks.empty()) {
+		std::pop_heap(m_clocks.begin(), m_clocks.end(), _later);
+		const Edge& _edge = _edges[m_clocks.back().second];
+		m_union_find.unite(_edge.m_vertex1, _edge.m_vertex2);
+		m_clocks.pop_back();
+	}
+	if (m_union_find.components() > t) {
+		return -1;
+	}
+
+	// Relabel the merged vertexes from 0 to t - 1, drop the loops, and sort the edges by first end
+	m_labels.assign(n, -1);
+	int _count = 0;
+	for (int v = 0; v < n; v++) {
+		int _root = m_union_find.find(v);
+		if (m_labels[_root] == -1) {
+			m_labels[_root] = _count++;
+		}
+	}
+	for (int v = 0; v < n; v++) {
+		m_labels[v] = m_labels[m_union_find.find(v)];
+	}
+	m_bucket_start.assign(_count + 1, 0);
+	for (const Edge& _edge : _edges) {
+		int a = m_labels[_edge.m_vertex1];
+		int b = m_labels[_edge.m_vertex2];
+		if (a != b) {
+			m_bucket_start[std::min(a, b) + 1]++;
+		}
+	}
+	for (int v = 0; v < _count; v++) {
+		m_bucket_start[v + 1] += m_bucket_start[v];
+	}
+	m_bucketed.resize(m_bucket_start[_count]);
+	for (const Edge& _edge : _edges) {
+		int a = m_labels[_edge.m_vertex1];
+		int b = m_labels[_edge.m_vertex2];
+		if (a != b) {
+			Edge _merged = { std::min(a, b), std::max(a, b), _edge.m_weight };
+			m_bucketed[m_bucket_start[_merged.m_vertex1]++] = _merged;
+		}
+	}
+
+	// Merge the parallel edges: within a bucket, the same second end means the same edge
+	std::vector<Edge>& _contracted = m_levels[_depth + 1];
+	_contracted.clear();
+	m_last_seen.assign(_count, -1);
+	m_last_position.resize(_count);
+	for (const Edge& _edge : m_bucketed) {
+		if (m_last_seen[_edge.m_vertex2] == _edge.m_vertex1) {
+			_contracted[m_last_position[_edge.m_vertex2]].m_weight += _edge.m_weight;
+		}
+		else {
+			m_last_seen[_edge.m_vertex2] = _edge.m_vertex1;
+			m_last_position[_edge.m_vertex2] = (int)_contracted.size();
+			_contracted.push_back(_edge);
+		}
+	}
+	return _count;
+}
+
+inline int Min_Cut_worker::exhaustive(const std::vector<Edge>& _edges, int n) {
+	// The last vertex is always on side 0 of the cut
+	int _best = std::numeric_limits<int>::max();
+	for (int _mask = 1; _mask < (1 << (n - 1)); _mask++) {
+		int _cut = 0;
+		for (const Edge& _edge : _edges) {
+			if (((_mask >> _edge.m_vertex1) & 1) != ((_mask >> _edge.m_vertex2) & 1)) {
+				_cut += _edge.m_weight;
+			}
+		}
+		_best = std::min(_best, _cut);
+	}
+	return _best;
+}
+
+inline int Min_Cut_worker::recurse(const std::vector<Edge>& _edges, int n, int _depth) {
+	if (n <= 6) {
+		return exhaustive(_edges, n);
+	}
+	int t = (int)std::ceil(1 + n / std::sqrt(2.0));
+	int _best = std::numeric_limits<int>::max();
+	for (int i = 0; i < 2; i++) {
+		int _contracted_count = contract(_edges, n, t, _depth);
+		if (_contracted_count < 0) {
+			return 0;
+		}
+		_best = std::min(_best, recurse(m_levels[_depth + 1], _contracted_count, _depth + 1));
+	}
+	return _best;
+}
+
+inline int Min_Cut_worker::karger_stein(const Graph& _graph) {
+	return recurse(_graph.m_edges, _graph.m_vertex_count, 0);
+}
+
+inline int Min_Cut_worker::karger(const Graph& _graph) {
+	if (contract(_graph.m_edges, _graph.m_vertex_count, 2, 0) < 0) {
+		return 0;
+	}
+	// Both vertexes are linked by a single merged edge
+	return m_levels[1].empty() ? 0 : m_levels[1][0].m_weight;
+}
+
+inline void Min_Cut_handler::run() {
+	int n = m_graph->m_vertex_count;
+	m_trials = 0;
+	if (n < 2) {
+		m_min_cut = 0;
+		m_target_trials = 0;
+		return;
+	}
+	if (n <= 6) {
+		// Small enough to be exact
+		m_min_cut = Min_Cut_worker(m_seed, 0).karger_stein(*m_graph);
+		m_trials = m_target_trials = 1;
+		return;
+	}
+
+	// (1 - p)^T <= exp(-p * T) <= 1 - confidence
+	double p = m_recursive ? 1 / (2 * std::log2((double)n)) : 2 / ((double)n * (n - 1));
+	m_target_trials = std::max(1LL, (long long)std::ceil(std::log(1 / (1 - m_confidence)) / p));
+
+	int _thread_count = m_threads > 0 ? m_threads : std::max(1, (int)std::thread::hardware_concurrency());
+	std::atomic<long long> _started(0);
+	std::atomic<long long> _done(0);
+	std::atomic<bool> _stop(false);
+	std::mutex _best_mutex;
+	int _best = std::numeric_limits<int>::max();
+
+	std::vector<std::thread> _threads;
+	for (int i = 0; i < _thread_count; i++) {
+		_threads.push_back(std::thread([&, i]() {
+			Min_Cut_worker _worker(m_seed, i);
+			while (!_stop && _started++ < m_target_trials) {
+				int _cut = m_recursive ? _worker.karger_stein(*m_graph) : _worker.karger(*m_graph);
+				_done++;
+				std::lock_guard<std::mutex> _lock(_best_mutex);
+				_best = std::min(_best, _cut);
+				// A disconnected graph cannot be cut further
+				if (_best == 0) {
+					_stop = true;
+				}
+			}
+		}));
+	}
+	for (std::thread& _thread : _threads) {
+		_thread.join();
+	}
+	m_min_cut = _best;
+	m_trials = _done;
+	INSTRUMENT_ADD("min_cut.trials", m_trials);
+}
+
+}
+
+#endif
@@ -0,0 +1,499 @@
+/*
+* Graph query server
+* This file keeps the graphs of 004_graph_kosaraju_scc_algorithm.hpp and 005_dijkstra_shortest_path_algorithm.hpp in memory,
+* and answers a stream of queries read from stdin or from a local Unix socket. The graphs are loaded and the SCCs computed
+* once at startup, so that the latency of a query only comes from the algorithm it needs.
+* The queries are read by batches (all the lines already received, up to --batch lines). Within a batch, the distance
+* and path queries are grouped by source: Dijkstra's algorithm runs once per source, its buffers being reused from one
+* source to the next, and the answers are written back in the order of the queries, with one flush per batch.
+*/
+
+/*
+* Usage: 012_graph_query_server [--scc FILE [--scc-vertices N]] [--dijkstra FILE [--dijkstra-vertices N]] [--socket PATH [--timeout S]] [--batch N]
+* The files are formatted as "SCC.txt" (see 004) and "dijkstraData.txt" (see 005). Vertexes are given by their index in the file.
+* The number of vertexes is the biggest index found in the file, or the given one if bigger (isolated vertexes).
+* One query per line, one answer per line:
+*	scc_summary [k]		-> ok <number of SCCs> <sizes of the k biggest SCCs (default 10)>
+*	component <v>		-> ok <id of the SCC of v> <size of this SCC>
+*	distance <s> <t>	-> ok <length of the shortest path from s to t>, or ok unreachable
+*	path <s> <t>		-> ok <s> ... <t>, or ok unreachable
+*	quit			-> closes the connection (stdin: stops the server)
+* A query that cannot be answered gets "error <reason>", an empty line included.
+* With --socket, the queries keep being read while the answers are sent, so that a client may write all its queries before
+* reading the answers. A client that reads none of its answers for --timeout seconds (default 10) is dropped.
+* An existing file at PATH is only replaced if it is a socket.
+*
+* Remark: the socket mode is only available on POSIX systems. One client is served at a time.
+*/
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "004_graph_kosaraju_scc_algorithm.hpp"
+#include "005_dijkstra_shortest_path_algorithm.hpp"
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#endif
+
+/*
+* ------------------ *
+* CLASS DECLARATIONS *
+* ------------------ *
+*/
+
+class Query_Server {
+public:
+	Query_Server(Kosaraju::Graph*, Dijkstra::Graph*);
+	~Query_Server();
+
+	void answer(const std::vector<std::string>&, std::string&);	// appends the answers of a batch of queries to the output
+	inline bool quit() { return m_quit; }				// true once a "quit" query has been read
+	inline void resume() { m_quit = false; }			// the next connection can be served
+
+private:
+	enum Kind { NONE, SCC_SUMMARY, COMPONENT, DISTANCE, PATH, QUIT, ERROR };
+
+	struct Query {
+		Kind kind;
+		int source;
+		int target;
+		std::string error;
+	};
+
+	Kosaraju::Graph* m_scc_graph;
+	Kosaraju::DFS_handler* m_dfs;
+	std::vector<int> m_scc_sizes;					// by decreasing size
+	Dijkstra::Graph* m_dijkstra_graph;
+	Dijkstra::DSP_handler_heap* m_dijkstra;
+	bool m_quit;
+
+	// Buffers reused from one batch to the next
+	std::vector<Query> m_queries;
+	std::vector<std::string> m_answers;
+	std::vector<int> m_by_source;					// the distance and path queries, sorted by source
+	std::istringstream m_parser;
+	std::vector<int> m_path;
+
+	void parse(const std::string&, Query&);
+	void answer_scc(const Query&, std::string&);
+	void answer_dijkstra(const Query&, std::string&);		// Dijkstra's algorithm must have been run from the source
+};
+
+/*
+* ----------------------- *
+* METHODS IMPLEMENTATIONS *
+* ----------------------- *
+*/
+
+Query_Server::Query_Server(Kosaraju::Graph* _scc_graph, Dijkstra::Graph* _dijkstra_graph) :
+	m_scc_graph(_scc_graph), m_dfs(nullptr), m_dijkstra_graph(_dijkstra_graph), m_dijkstra(nullptr), m_quit(false) {
+	if (m_scc_graph != nullptr) {
+		INSTRUMENT_SCOPED_TIMER("server.scc");
+		m_dfs = new Kosaraju::DFS_handler(m_scc_graph);
+		m_dfs->DFS_Loop_Reversed();
+		m_dfs->DFS_Loop_SCC();
+		m_scc_sizes = *m_dfs->getSCC();
+		std::reverse(m_scc_sizes.begin(), m_scc_sizes.end());
+	}
+	if (m_dijkstra_graph != nullptr) {
+		m_dijkstra = new Dijkstra::DSP_handler_heap(m_dijkstra_graph);
+	}
+}
+
+Query_Server::~Query_Server() {
+	delete m_dfs;
+	delete m_dijkstra;
+}
+
+void Query_Server::parse(const std::string& _line, Query& _query) {
+	_query.kind = NONE;
+	_query.error.clear();
+	m_parser.clear();
+	m_parser.str(_line);
+
+	std::string _command;
+	if (!(m_parser >> _command)) {
+		_query.kind = ERROR;
+		_query.error = "empty query";
+		return;
+	}
+
+	if (_command == "quit") {
+		_query.kind = QUIT;
+	}
+	else if (_command == "scc_summary" || _command == "component") {
+		_query.kind = _command == "component" ? COMPONENT : SCC_SUMMARY;
+		if (m_scc_graph == nullptr) {
+			_query.kind = ERROR;
+			_query.error = "no SCC graph loaded";
+			return;
+		}
+		if (_query.kind == SCC_SUMMARY) {
+			_query.source = 10;
+			if (!(m_parser >> _query.source)) {
+				_query.source = 10;
+			}
+		}
+		else if (!(m_parser >> _query.source) || _query.source < 1 || _query.source > (int)m_scc_graph->_vertexes.size()) {
+			_query.kind = ERROR;
+			_query.error = "invalid vertex";
+		}
+	}
+	else if (_command == "distance" || _command == "path") {
+		_query.kind = _command == "path" ? PATH : DISTANCE;
+		if (m_dijkstra_graph == nullptr) {
+			_query.kind = ERROR;
+			_query.error = "no shortest path graph loaded";
+			return;
+		}
+		int n = (int)m_dijkstra_graph->m_vertexes.size();
+		if (!(m_parser >> _query.source >> _query.target) || _query.source < 1 || _query.source > n || _query.target < 1 || _query.target > n) {
+			_query.kind = ERROR;
+			_query.error = "invalid vertex";
+		}
+	}
+	else {
+		_query.kind = ERROR;
+		_query.error = "unknown query " + _command;
+	}
+}
+
+void Query_Server::answer_scc(const Query& _query, std::string& _out) {
+	_out = "ok";
+	if (_query.kind == SCC_SUMMARY) {
+		_out += " " + std::to_string(m_scc_sizes.size());
+		for (int i = 0; i < _query.source && i < (int)m_scc_sizes.size(); i++) {
+			_out += " " + std::to_string(m_scc_sizes[i]);
+		}
+	}
+	else {
+		int _component = m_scc_graph->_vertexes[_query.source - 1]->_component;
+		_out += " " + std::to_string(_component) + " " + std::to_string(m_dfs->getComponentSize(_component));
+	}
+}
+
+void Query_Server::answer_dijkstra(const Query& _query, std::string& _out) {
+	Dijkstra::Vertex* _target = m_dijkstra_graph->m_vertexes[_query.target - 1];
+	int _distance = m_dijkstra->getDistance(_target);
+	if (_distance == std::numeric_limits<int>::max()) {
+		_out = "ok unreachable";
+		return;
+	}
+	_out = "ok";
+	if (_query.kind == DISTANCE) {
+		_out += " " + std::to_string(_distance);
+		return;
+	}
+
+	// The path is given from the target back to the source
+	std::vector<Dijkstra::Edge*>* _reversed_path = m_dijkstra->getReversedPath(_target);
+	m_path.clear();
+	m_path.push_back(_target->m_index);
+	Dijkstra::Vertex* _current = _target;
+	for (Dijkstra::Edge* _edge : *_reversed_path) {
+		_current = _edge->getOtherEnd(_current);
+		m_path.push_back(_current->m_index);
+	}
+	delete _reversed_path;
+	for (std::vector<int>::reverse_iterator rit = m_path.rbegin(); rit != m_path.rend(); rit++) {
+		_out += " " + std::to_string(*rit);
+	}
+}
+
+void Query_Server::answer(const std::vector<std::string>& _lines, std::string& _out) {
+	INSTRUMENT_SCOPED_TIMER("server.batch");
+	INSTRUMENT_ADD("server.queries", _lines.size());
+
+	// Parse the whole batch; the queries after a "quit" are dropped
+	m_queries.resize(_lines.size());
+	size_t _count = 0;
+	for (; _count < _lines.size() && !m_quit; _count++) {
+		parse(_lines[_count], m_queries[_count]);
+		m_quit = m_queries[_count].kind == QUIT;
+	}
+	if (m_answers.size() < _count) {
+		m_answers.resize(_count);
+	}
+
+	// Run Dijkstra's algorithm once per source
+	m_by_source.clear();
+	for (size_t i = 0; i < _count; i++) {
+		if (m_queries[i].kind == DISTANCE || m_queries[i].kind == PATH) {
+			m_by_source.push_back((int)i);
+		}
+	}
+	std::stable_sort(m_by_source.begin(), m_by_source.end(), [&](int a, int b) { return m_queries[a].source < m_queries[b].source; });
+	int _last_source = -1;
+	for (int i : m_by_source) {
+		if (m_queries[i].source != _last_source) {
+			INSTRUMENT_SCOPED_TIMER("server.dijkstra");
+			_last_source = m_queries[i].source;
+			m_dijkstra->run(m_dijkstra_graph->m_vertexes[_last_source - 1]);
+		}
+		answer_dijkstra(m_queries[i], m_answers[i]);
+	}
+
+	// Write the answers in the order of the queries
+	for (size_t i = 0; i < _count; i++) {
+		switch (m_queries[i].kind) {
+		case NONE:
+		case QUIT:
+			continue;
+		case SCC_SUMMARY:
+		case COMPONENT:
+			answer_scc(m_queries[i], m_answers[i]);
+			break;
+		case ERROR:
+			m_answers[i] = "error " + m_queries[i].error;
+			break;
+		default:
+			break;
+		}
+		_out += m_answers[i];
+		_out += '\n';
+	}
+}
+
+/*
+* ------- *
+* SERVING *
+* ------- *
+*/
+
+// Answers the queries of stdin, a batch being the lines already buffered
+void serve_stdin(Query_Server& _server, size_t _batch_size) {
+	std::vector<std::string> _batch;
+	std::string _line;
+	std::string _out;
+	while (!_server.quit() && std::getline(std::cin, _line)) {
+		_batch.clear();
+		_batch.push_back(_line);
+		while (_batch.size() < _batch_size && std::cin.rdbuf()->in_avail() > 0 && std::getline(std::cin, _line)) {
+			_batch.push_back(_line);
+		}
+		_out.clear();
+		_server.answer(_batch, _out);
+		std::cout << _out << std::flush;
+	}
+}
+
+#ifndef _WIN32
+// Answers the queries of the clients of a Unix socket, a batch being the complete lines received so far.
+// Each connection is driven by poll(): the queries are read while answers are waiting to be sent. The answering stops
+// while too many answers are waiting, and the reading while too many queries are waiting, so that the memory stays bounded.
+bool serve_socket(Query_Server& _server, const std::string& _path, size_t _batch_size, int _timeout) {
+	const size_t _max_waiting = 1 << 22;
+	int _listener = socket(AF_UNIX, SOCK_STREAM, 0);
+	sockaddr_un _address;
+	std::memset(&_address, 0, sizeof(_address));
+	_address.sun_family = AF_UNIX;
+	if (_listener < 0 || _path.size() >= sizeof(_address.sun_path)) {
+		return false;
+	}
+	std::strcpy(_address.sun_path, _path.c_str());
+	struct stat _status;
+	if (lstat(_path.c_str(), &_status) == 0) {
+		if (!S_ISSOCK(_status.st_mode)) {
+			std::cerr << _path << " exists and is not a socket" << std::endl;
+			close(_listener);
+			return false;
+		}
+		unlink(_path.c_str());
+	}
+	if (bind(_listener, (sockaddr*)&_address, sizeof(_address)) < 0 || listen(_listener, 16) < 0) {
+		close(_listener);
+		return false;
+	}
+	std::cout << "Listening on " << _path << std::endl;
+
+	// A client leaving before reading its answers must only end its own connection, not the server
+	signal(SIGPIPE, SIG_IGN);
+
+	std::vector<char> _buffer(1 << 16);
+	std::string _pending;						// received, not answered yet
+	std::vector<std::string> _batch;
+	std::string _out;						// answered, not sent yet (from _written on)
+	int _client;
+	while ((_client = accept(_listener, nullptr, nullptr)) >= 0 || errno == EINTR) {
+		if (_client < 0) {
+			continue;
+		}
+		fcntl(_client, F_SETFL, fcntl(_client, F_GETFL) | O_NONBLOCK);
+		_pending.clear();
+		_out.clear();
+		size_t _written = 0;
+		_server.resume();
+		bool _reading = true;					// until the client closes its side
+		while (true) {
+			// Every complete line received so far is answered, by batches of at most _batch_size
+			size_t _start = 0;
+			size_t _end;
+			while (!_server.quit() && _out.size() - _written < _max_waiting && (_end = _pending.find('\n', _start)) != std::string::npos) {
+				_batch.clear();
+				while (_batch.size() < _batch_size && _end != std::string::npos) {
+					_batch.push_back(_pending.substr(_start, _end - _start));
+					_start = _end + 1;
+					_end = _pending.find('\n', _start);
+				}
+				_server.answer(_batch, _out);
+			}
+			_pending.erase(0, _start);
+
+			bool _sending = _written < _out.size();
+			bool _receiving = _reading && !_server.quit() && _pending.size() < _max_waiting;
+			if (!_sending && !_receiving) {
+				break;
+			}
+			pollfd _poll;
+			_poll.fd = _client;
+			_poll.events = (_receiving ? POLLIN : 0) | (_sending ? POLLOUT : 0);
+			_poll.revents = 0;
+			int _ready = poll(&_poll, 1, _sending ? 1000 * _timeout : -1);
+			if (_ready < 0 && errno == EINTR) {
+				continue;
+			}
+			// Error, or the client has not read any answer in time: drop it
+			if (_ready <= 0 || (_poll.revents & (POLLERR | POLLNVAL))) {
+				break;
+			}
+			if (_poll.revents & (POLLIN | POLLHUP)) {
+				ssize_t _read = read(_client, _buffer.data(), _buffer.size());
+				if (_read > 0) {
+					_pending.append(_buffer.data(), _read);
+				}
+				else if (_read == 0 || (errno != EAGAIN && errno != EINTR)) {
+					_reading = false;
+				}
+			}
+			if (_sending && (_poll.revents & (POLLOUT | POLLHUP))) {
+				ssize_t _sent = send(_client, _out.data() + _written, _out.size() - _written, 0);
+				// The client is gone: drop the rest of its queries
+				if (_sent < 0 && errno != EAGAIN && errno != EINTR) {
+					break;
+				}
+				_written += std::max<ssize_t>(_sent, 0);
+				if (_written == _out.size() || _written >= _max_waiting) {
+					_out.erase(0, _written);
+					_written = 0;
+				}
+			}
+		}
+		close(_client);
+	}
+	close(_listener);
+	unlink(_path.c_str());
+	return true;
+}
+#endif
+
+/*
+* ---- *
+* MAIN *
+* ---- *
+*/
+
+int main(int argc, char** argv) {
+	std::string _scc_file;
+	int _scc_vertices = 0;
+	std::string _dijkstra_file;
+	int _dijkstra_vertices = 0;
+	std::string _socket;
+	int _timeout = 10;
+	size_t _batch_size = 1024;
+
+	for (int i = 1; i < argc; i++) {
+		std::string _argument = argv[i];
+		if (i + 1 >= argc) {
+			std::cerr << "Missing value for " << _argument << std::endl;
+			return 1;
+		}
+		std::string _value = argv[++i];
+		if (_argument == "--scc") {
+			_scc_file = _value;
+		}
+		else if (_argument == "--scc-vertices") {
+			_scc_vertices = std::stoi(_value);
+		}
+		else if (_argument == "--dijkstra") {
+			_dijkstra_file = _value;
+		}
+		else if (_argument == "--dijkstra-vertices") {
+			_dijkstra_vertices = std::stoi(_value);
+		}
+		else if (_argument == "--socket") {
+			_socket = _value;
+		}
+		else if (_argument == "--timeout") {
+			_timeout = std::max(1, std::stoi(_value));
+		}
+		else if (_argument == "--batch") {
+			_batch_size = std::max(1, std::stoi(_value));
+		}
+		else {
+			std::cerr << "Unknown option " << _argument << std::endl;
+			return 1;
+		}
+	}
+
+	// The buffer of std::cin tells how many queries are already waiting
+	std::ios::sync_with_stdio(false);
+
+	Kosaraju::Graph* _scc_graph = nullptr;
+	if (!_scc_file.empty()) {
+		INSTRUMENT_SCOPED_TIMER("server.scc_load");
+		std::ifstream _file(_scc_file);
+		if (!_file.is_open()) {
+			std::cerr << "Unable to read file!" << std::endl;
+			return 1;
+		}
+		_scc_graph = Kosaraju::ReadGraph(_file, _scc_vertices);
+	}
+	Dijkstra::Graph* _dijkstra_graph = nullptr;
+	if (!_dijkstra_file.empty()) {
+		INSTRUMENT_SCOPED_TIMER("server.dijkstra_load");
+		std::ifstream _file(_dijkstra_file);
+		if (!_file.is_open()) {
+			std::cerr << "Unable to read file!" << std::endl;
+			return 1;
+		}
+		_dijkstra_graph = Dijkstra::ReadGraph(_file, _dijkstra_vertices);
+	}
+
+	Query_Server _server(_scc_graph, _dijkstra_graph);
+	std::cerr << "Ready" << std::endl;
+
+	if (_socket.empty()) {
+		serve_stdin(_server, _batch_size);
+	}
+	else {
+#ifndef _WIN32
+		if (!serve_socket(_server, _socket, _batch_size, _timeout)) {
+			std::cerr << "Unable to open socket " << _socket << std::endl;
+			return 1;
+		}
+#else
+		std::cerr << "Sockets are not supported on this platform" << std::endl;
+		return 1;
+#endif
+	}
+
+	INSTRUMENT_DUMP_JSON(std::cerr);
+
+	delete _scc_graph;
+	delete _dijkstra_graph;
+
+	return 0;
+}
@@ -0,0 +1,312 @@
+/*
+* Sorting kernels
+* Native versions of Python/001_count_inversions_merge_sort.py and Python/002_quick_sort.py:
+*	- Inversions_handler: merge sort counting the inversions on 64 bits. The halves are sorted by parallel tasks
+*	  down to a minimum size. Each level sorts from one array into the other (ping-pong), so the only buffer is
+*	  allocated once and kept between runs.
+*	- Quick_Sort_handler: quick sort with the pivot rules of Python/002 (first, last, median of three) and Tukey's ninther
+*	  (median of three medians of three). As an introsort, small ranges are finished by insertion sort and the ranges
+*	  recursing too deep (bad pivots) are sorted by heapsort with the heap of 006_heaps_template.hpp.
+*	- kendall_tau_distance: the number of pairs ranked in a different order by two rankings, as an inversion count.
+*/
+
+/*
+* Usage:
+*	Inversions_handler<int> _inversions;
+*	unsigned long long _count = _inversions.run(v);				// sorts v, returns its number of inversions
+*	long long _comparisons = Quick_Sort_handler<int>(PIVOT_FIRST, false).run(v);	// as Python/002
+*/
+
+#ifndef SORTING_KERNELS_H
+#define SORTING_KERNELS_H
+
+#include <vector>
+#include <string>
+#include <future>
+#include <thread>
+#include <algorithm>
+#include <utility>
+#include <cmath>
+#include "006_heaps_template.hpp"
+#include "008_instrumentation.hpp"
+
+namespace Sorting {
+
+/*
+* ------------------ *
+* CLASS DECLARATIONS *
+* ------------------ *
+*/
+
+enum Pivot_Rule {
+	PIVOT_FIRST,						// the first element of the range
+	PIVOT_LAST,						// the last element of the range
+	PIVOT_MEDIAN_OF_THREE,					// the median of the first, middle and last elements
+	PIVOT_NINTHER						// the median of the medians of three groups of three elements
+};
+
+Pivot_Rule make_pivot_rule(const std::string&);		// given a name ("first", "last", "median_of_three", "ninther")
+
+/*
+* Merge sort counting the inversions, i.e. the pairs i < j such that v[j] < v[i]
+*/
+template <typename T>
+class Inversions_handler {
+public:
+	inline Inversions_handler(int _threads = 0) : m_threads(_threads) {}	// 0: one task per hardware thread
+	unsigned long long run(std::vector<T>&);		// sorts the vector, returns its number of inversions
+
+private:
+	int m_threads;
+	std::vector<T> m_buffer;				// ping-pong buffer, kept between runs
+
+	unsigned long long sort(T*, T*, size_t, int);		// given (source, target, size, tasks), both arrays holding the same elements, sorts them into target
+	static unsigned long long task_count(size_t, int);	// number of tasks launched by sort for (size, tasks)
+	unsigned long long merge(const T*, size_t, const T*, size_t, T*);
+	unsigned long long insertion_sort(T*, size_t);
+};
+
+/*
+* Quick sort. Without introsort, this is exactly the algorithm of Python/002 (partition around the pivot moved first).
+*/
+template <typename T>
+class Quick_Sort_handler {
+public:
+	inline Quick_Sort_handler(Pivot_Rule _rule = PIVOT_MEDIAN_OF_THREE, bool _introsort = true) : m_rule(_rule), m_introsort(_introsort) {}
+	long long run(std::vector<T>&);				// sorts the vector, returns the number of comparisons of the partitions
+
+private:
+	Pivot_Rule m_rule;
+	bool m_introsort;
+	Heap_Min<T> m_heap;
+
+	size_t choose_pivot(T*, size_t, size_t);		// given (array, lb, ub), returns the index of the pivot in [lb, ub)
+	size_t median_of_three(T*, size_t, size_t, size_t);	// returns the index of the median of the 3 given indexes
+	long long sort(T*, size_t, size_t, int);		// sorts [lb, ub), given the remaining depth before heapsort
+	void heap_sort(T*, size_t, size_t);
+	void insertion_sort(T*, size_t, size_t);
+};
+
+// Number of pairs of items ranked in a different order. Both rankings list the items 0 to n - 1, from first to last.
+unsigned long long kendall_tau_distance(const std::vector<int>&, const std::vector<int>&, int _threads = 0);
+
+/*
+* ----------------------- *
+* METHODS IMPLEMENTATIONS *
+* ----------------------- *
+*/
+
+inline Pivot_Rule make_pivot_rule(const std::string& _name) {
+	if (_name == "first") {
+		return PIVOT_FIRST;
+	}
+	if (_name == "last") {
+		return PIVOT_LAST;
+	}
+	if (_name == "ninther") {
+		return PIVOT_NINTHER;
+	}
+	return PIVOT_MEDIAN_OF_THREE;
+}
+
+template <typename T>
+unsigned long long Inversions_handler<T>::run(std::vector<T>& _vector) {
+	m_buffer.assign(_vector.begin(), _vector.end());
+	int _tasks = m_threads > 0 ? m_threads : std::max(1, (int)std::thread::hardware_concurrency());
+	// Counted here: the counters are not thread-safe
+	INSTRUMENT_ADD("sort.merge_tasks", task_count(_vector.size(), _tasks));
+	return sort(m_buffer.data(), _vector.data(), _vector.size(), _tasks);
+}
+
+template <typename T>
+unsigned long long Inversions_handler<T>::sort(T* _source, T* _target, size_t n, int _tasks) {
+	if (n <= 32) {
+		return insertion_sort(_target, n);
+	}
+	// Sort both halves of the target into the source, then merge them back into the target
+	size_t _half = n / 2;
+	unsigned long long _inversions;
+	if (_tasks > 1 && n >= (1 << 16)) {
+		std::future<unsigned long long> _left = std::async(std::launch::async, &Inversions_handler<T>::sort, this, _target, _source, _half, _tasks / 2);
+		_inversions = sort(_target + _half, _source + _half, n - _half, _tasks - _tasks / 2);
+		_inversions += _left.get();
+	}
+	else {
+		_inversions = sort(_target, _source, _half, 1);
+		_inversions += sort(_target + _half, _source + _half, n - _half, 1);
+	}
+	return _inversions + merge(_source, _half, _source + _half, n - _half, _target);
+}
+
+template <typename T>
+unsigned long long Inversions_handler<T>::task_count(size_t n, int _tasks) {
+	if (_tasks <= 1 || n < (1 << 16)) {
+		return 0;
+	}
+	return 1 + task_count(n / 2, _tasks / 2) + task_count(n - n / 2, _tasks - _tasks / 2);
+}
+
+template <typename T>
+unsigned long long Inversions_handler<T>::merge(const T* _left, size_t _left_size, const T* _right, size_t _right_size, T* _target) {
+	unsigned long long _inversions = 0;
+	size_t i = 0;
+	size_t j = 0;
+	while (i < _left_size && j < _right_size) {
+		if (_right[j] < _left[i]) {
+			// The element jumps over all the remaining elements of the left half
+			_inversions += _left_size - i;
+			*_target++ = _right[j++];
+		}
+		else {
+			*_target++ = _left[i++];
+		}
+	}
+	_target = std::copy(_left + i, _left + _left_size, _target);
+	std::copy(_right + j, _right + _right_size, _target);
+	return _inversions;
+}
+
+template <typename T>
+unsigned long long Inversions_handler<T>::insertion_sort(T* _array, size_t n) {
+	// Each shift fixes exactly one inversion
+	unsigned long long _inversions = 0;
+	for (size_t i = 1; i < n; i++) {
+		T _element = _array[i];
+		size_t j = i;
+		while (j > 0 && _element < _array[j - 1]) {
+			_array[j] = _array[j - 1];
+			j--;
+		}
+		_inversions += i - j;
+		_array[j] = _element;
+	}
+	return _inversions;
+}
+
+template <typename T>
+long long Quick_Sort_handler<T>::run(std::vector<T>& _vector) {
+	// Introsort: past 2*log2(n) levels, the pivots are bad enough to switch to heapsort
+	int _depth = 2 * (int)std::log2((double)std::max<size_t>(_vector.size(), 1));
+	return sort(_vector.data(), 0, _vector.size(), _depth);
+}
+
+template <typename T>
+size_t Quick_Sort_handler<T>::median_of_three(T* _array, size_t a, size_t b, size_t c) {
+	if (_array[a] < _array[b]) {
+		return _array[b] < _array[c] ? b : (_array[a] < _array[c] ? c : a);
+	}
+	return _array[a] < _array[c] ? a : (_array[b] < _array[c] ? c : b);
+}
+
+template <typename T>
+size_t Quick_Sort_handler<T>::choose_pivot(T* _array, size_t lb, size_t ub) {
+	if (m_rule == PIVOT_FIRST) {
+		return lb;
+	}
+	if (m_rule == PIVOT_LAST) {
+		return ub - 1;
+	}
+	if (m_rule == PIVOT_NINTHER && ub - lb >= 64) {
+		size_t s = (ub - lb) / 8;
+		size_t m = lb + (ub - lb) / 2;
+		return median_of_three(_array, median_of_three(_array, lb, lb + s, lb + 2 * s), median_of_three(_array, m - s, m, m + s),
+			median_of_three(_array, ub - 1 - 2 * s, ub - 1 - s, ub - 1));
+	}
+
+	// Median of three, with the middle element and the tie-breaking of Python/002 (also the ninther of small ranges)
+	size_t _middle = (lb + ub) / 2;
+	if ((ub - lb) % 2 == 0) {
+		_middle--;
+	}
+	T& _first = _array[lb];
+	T& _mid = _array[_middle];
+	T& _last = _array[ub - 1];
+	if ((_first < _mid && _mid < _last) || (_last < _mid && _mid < _first)) {
+		return _middle;
+	}
+	if ((_first < _last && _last < _mid) || (_mid < _last && _last < _first)) {
+		return ub - 1;
+	}
+	return lb;
+}
+
+template <typename T>
+long long Quick_Sort_handler<T>::sort(T* _array, size_t lb, size_t ub, int _depth) {
+	long long _comparisons = 0;
+	while (ub - lb > 1) {
+		if (m_introsort) {
+			if (ub - lb <= 16) {
+				insertion_sort(_array, lb, ub);
+				break;
+			}
+			if (_depth-- == 0) {
+				heap_sort(_array, lb, ub);
+				break;
+			}
+		}
+
+		// Move the pivot first, gather the smaller elements right after it, then put it between both parts
+		std::swap(_array[lb], _array[choose_pivot(_array, lb, ub)]);
+		size_t i = lb;
+		for (size_t j = lb + 1; j < ub; j++) {
+			if (_array[j] < _array[lb]) {
+				std::swap(_array[++i], _array[j]);
+			}
+		}
+		std::swap(_array[i], _array[lb]);
+		_comparisons += ub - lb - 1;
+
+		// Recurse on the smaller part only, so that the stack stays in O(log(n))
+		if (i - lb < ub - i - 1) {
+			_comparisons += sort(_array, lb, i, _depth);
+			lb = i + 1;
+		}
+		else {
+			_comparisons += sort(_array, i + 1, ub, _depth);
+			ub = i;
+		}
+	}
+	return _comparisons;
+}
+
+template <typename T>
+void Quick_Sort_handler<T>::heap_sort(T* _array, size_t lb, size_t ub) {
+	INSTRUMENT_ADD("sort.heapsort_fallbacks", 1);
+	for (size_t i = lb; i < ub; i++) {
+		m_heap.push(_array[i]);
+	}
+	for (size_t i = lb; i < ub; i++) {
+		_array[i] = m_heap.pop();
+	}
+}
+
+template <typename T>
+void Quick_Sort_handler<T>::insertion_sort(T* _array, size_t lb, size_t ub) {
+	for (size_t i = lb + 1; i < ub; i++) {
+		T _element = _array[i];
+		size_t j = i;
+		while (j > lb && _element < _array[j - 1]) {
+			_array[j] = _array[j - 1];
+			j--;
+		}
+		_array[j] = _element;
+	}
+}
+
+inline unsigned long long kendall_tau_distance(const std::vector<int>& _ranking1, const std::vector<int>& _ranking2, int _threads) {
+	// Rank in the second ranking of each item, listed in the order of the first ranking
+	std::vector<int> _rank(_ranking2.size());
+	for (size_t i = 0; i < _ranking2.size(); i++) {
+		_rank[_ranking2[i]] = (int)i;
+	}
+	std::vector<int> _ranks;
+	_ranks.reserve(_ranking1.size());
+	for (int _item : _ranking1) {
+		_ranks.push_back(_rank[_item]);
+	}
+	return Inversions_handler<int>(_threads).run(_ranks);
+}
+
+}
+
+#endif